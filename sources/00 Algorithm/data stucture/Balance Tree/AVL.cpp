@@ -1,38 +1,59 @@
-#include <bits/stdc++.h>
-
-template<typename Key, typename Value, typename Compare = std::less<Key>()>
-class AVL {
-public:
-  AVL() : size(0), root(0), compare(Compare()) {}
-
-  struct Node {
-    Node(int key, int value) : key(key), value(value) {}
-    int key;
-    int value;
-    Node* left;
-    Node* right;
-    int height;
-  };
-
-  Node* insert(const Key& key, const Value& value, Node* root);
-
-  Node* root;
-  int size;
-  Compare compare;
-};
-
-int getHeight(Node)
-
-template<typename Key, typename Value, typename Compare>
-AVL<Key, Value, Compare>::Node* AVL<Key, Value, Compare>::insert(const Key& key, const Value& value, Node* node) {
-  if (node == nullptr) {
-    ++size;
-    return new Node(key, value);
-  }
-
-  if (compare(key, node->key)) node->left = insert(key, value, node->left);
-  else if (key != node->key) node->right = insert(key, value, node->right);
-  else node->value = value;
-
-  node->height = 1 + std::max()
-}
\ No newline at end of file
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "AVL.h"
+#include "../flat_tree.h"
+
+int main() {
+  AVL<int, std::string> avl;
+  for (int i = 1; i <= 1000; ++i) avl.insert(i, std::to_string(i * i));
+  std::cout << "size: " << avl.size() << ", height: " << avl.height() << std::endl;
+
+  for (int i = 1; i <= 1000; i += 2) avl.erase(i);
+  std::cout << "size: " << avl.size() << ", height: " << avl.height() << std::endl;
+
+  std::cout << "find 10: " << *avl.find(10) << ", find 11: " << (avl.find(11) ? "yes" : "no") << std::endl;
+  std::cout << "lower_bound 11: " << avl.lower_bound(11)->key << std::endl;
+  std::cout << "upper_bound 12: " << avl.upper_bound(12)->key << std::endl;
+
+  AVL<std::string, int> words;
+  for (const char* w : {"Piglet", "Eeyore", "Roo", "Tigger", "Chris", "Pooh", "Kanga"}) words.insert(w, 1);
+  words.for_each([](const std::string& k, int) { std::cout << k << " "; });
+  std::cout << std::endl;
+
+  // 排行榜：分数 -> 玩家，维护子树大小后可直接查名次和分位数
+  AVL<int, std::string, std::greater<int>, avl_order_statistic> board;
+  board.insert(980, "Pooh");
+  board.insert(1200, "Tigger");
+  board.insert(760, "Eeyore");
+  board.insert(1100, "Kanga");
+  board.insert(900, "Roo");
+  std::cout << "players above 1000: " << board.rank(1000) << std::endl;
+  std::cout << "3rd place: " << board.select(2)->value << std::endl;
+  std::cout << "scores in [1100, 900]: " << board.count_range(1100, 900) << std::endl;
+
+  // 有序快照直接 O(n) 建树，再做集合运算
+  std::vector<std::pair<int, int>> evens, triples;
+  for (int i = 0; i < 1000000; ++i) evens.emplace_back(2 * i, 2);
+  for (int i = 0; i < 1000000; ++i) triples.emplace_back(3 * i, 3);
+  AVL<int, int> a = AVL<int, int>::from_sorted(evens.begin(), evens.end());
+  AVL<int, int> b = AVL<int, int>::from_sorted(triples.begin(), triples.end());
+  std::cout << "bulk-loaded height: " << a.height() << std::endl;
+
+  AVL<int, int> both = AVL<int, int>::set_intersection(a, b);
+  AVL<int, int> either = AVL<int, int>::set_union(std::move(a), std::move(b));
+  std::cout << "multiples of 6: " << both.size() << ", multiples of 2 or 3: " << either.size() << std::endl;
+
+  AVL<int, int> low, high;
+  either.split(1000, low, high);
+  std::cout << "below 1000: " << low.size() << ", from 1000: " << high.size() << std::endl;
+
+  // 写成扁平文件，之后的进程直接 mmap 查询，不必重建
+  write_flat_tree<int, int>("/tmp/avl_demo.idx", high);
+  FlatTree<int, int> mapped("/tmp/avl_demo.idx");
+  std::cout << "mapped size: " << mapped.size() << ", contains 1002: " << mapped.contains(1002)
+            << ", contains 1001: " << mapped.contains(1001) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,659 @@
+#ifndef AVL_H
+#define AVL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+#include "../node_pool.h"
+
+// AVL 有序映射：任意节点左右子树高度差不超过 1，树高 <= 1.44 log(n+2)。
+// insert/erase 递归下降，回溯时 update() 重新计算高度并在失衡处旋转。
+// 节点来自每棵树自己的 NodePool（按块分配 + 空闲链表），插入密集时不会频繁调用 malloc；
+// 高度存成 int8_t（AVL 树高不可能超过 127），让节点更紧凑。
+// split/join/集合运算会让节点在树之间转移，所以树通过 shared_ptr 引用内存池；
+// 两个池相遇时用 NodePool::absorb 合并，被合并的池留下一个指向新池的 parent（并查集），
+// 所有曾经引用它的树都会找到同一个池。共享内存池的几棵树不能在不同线程上同时修改。
+//
+// Policy 决定节点上额外维护的信息：
+//   avl_plain           什么都不加（默认），空基类优化后节点大小不变；
+//   avl_order_statistic 每个节点记录子树大小，在 update() 中随旋转一起维护，
+//                       提供 O(log n) 的 rank/select/count_range。
+struct avl_plain {
+  struct node_data {};
+  static constexpr bool sized = false;
+};
+
+struct avl_order_statistic {
+  struct node_data {
+    std::size_t size = 1;
+  };
+  static constexpr bool sized = true;
+};
+
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Policy = avl_plain>
+class AVL {
+public:
+  struct Node : Policy::node_data {
+    Node(const Key& key, const Value& value) : key(key), value(value) {}
+    Key key;
+    Value value;
+    Node* left = nullptr;
+    Node* right = nullptr;
+    std::int8_t height = 1;
+  };
+
+  AVL(const Compare& cmp = Compare()) : compare(cmp) {}
+  AVL(const AVL& rhs) : compare(rhs.compare) {
+    root = clone(rhs.root);
+    count = rhs.count;
+  }
+  AVL(AVL&& rhs) noexcept
+      : root(rhs.root), count(rhs.count), pool(std::move(rhs.pool)), compare(rhs.compare) {
+    rhs.root = nullptr, rhs.count = 0;
+  }
+  AVL& operator=(AVL rhs) noexcept {
+    clear();
+    std::swap(root, rhs.root);
+    std::swap(count, rhs.count);
+    std::swap(pool, rhs.pool);
+    std::swap(compare, rhs.compare);
+    return *this;
+  }
+  ~AVL() { clear(); }
+
+  // 键已存在时覆盖 value 并返回 false
+  bool insert(const Key& key, const Value& value);
+  bool erase(const Key& key);
+
+  Value* find(const Key& key) { return const_cast<Value*>(static_cast<const AVL*>(this)->find(key)); }
+  const Value* find(const Key& key) const;
+  bool contains(const Key& key) const { return find(key) != nullptr; }
+  // 第一个 >= key / > key 的节点，不存在时返回 nullptr
+  const Node* lower_bound(const Key& key) const;
+  const Node* upper_bound(const Key& key) const;
+
+  // 按键的顺序访问每个节点：f(key, value)
+  template <typename F>
+  void for_each(F f) const { walk(root, f); }
+
+  // 以下三个查询需要 Policy = avl_order_statistic
+  // 严格小于 key 的元素个数
+  std::size_t rank(const Key& key) const;
+  // 第 k 小（从 0 开始）的节点，k >= size() 时返回 nullptr
+  const Node* select(std::size_t k) const;
+  // 落在闭区间 [lo, hi] 内的元素个数
+  std::size_t count_range(const Key& lo, const Key& hi) const;
+
+  // 由按键严格递增的 (key, value) 序列直接建出完全平衡的树，O(n)
+  template <typename ForwardIt>
+  static AVL from_sorted(ForwardIt first, ForwardIt last, const Compare& cmp = Compare());
+  // 把本树拆成 < key 的 left 和 >= key 的 right，本树变为空，O(log n)
+  void split(const Key& key, AVL& left, AVL& right);
+  // 要求 left 的键都小于 key、right 的键都大于 key；两棵树被消耗，O(|h(left) - h(right)|)
+  static AVL join(AVL& left, const Key& key, const Value& value, AVL& right);
+
+  // 基于 split/join 的集合运算，消耗两个参数。较大的子问题会分叉到其他线程，
+  // 分叉深度为 log2(threads)。键相同时保留 a 中的 value。
+  static AVL set_union(AVL a, AVL b, unsigned threads = std::thread::hardware_concurrency());
+  static AVL set_intersection(AVL a, AVL b, unsigned threads = std::thread::hardware_concurrency());
+  static AVL set_difference(AVL a, AVL b, unsigned threads = std::thread::hardware_concurrency());
+
+  // split 之后元素个数要到第一次调用 size() 时才数一遍
+  std::size_t size() const {
+    if (count == unknown) count = tally(root);
+    return count;
+  }
+  bool empty() const { return root == nullptr; }
+  int height() const { return height(root); }
+  void clear() {
+    destroy(root);
+    root = nullptr;
+    count = 0;
+  }
+
+private:
+  static constexpr std::size_t unknown = static_cast<std::size_t>(-1);
+  static std::size_t tally(const Node* node) {
+    if constexpr (Policy::sized) return size(node);
+    else return node ? 1 + tally(node->left) + tally(node->right) : 0;
+  }
+  struct Pool {
+    NodePool<Node> nodes;
+    std::shared_ptr<Pool> parent;  // 已经并入别的池时指向它
+  };
+  // 沿 parent 找到实际持有内存的池，顺便把 pool 直接指过去
+  const std::shared_ptr<Pool>& live_pool() {
+    if (!pool) pool = std::make_shared<Pool>();
+    while (pool->parent) pool = pool->parent;
+    return pool;
+  }
+  NodePool<Node>& nodes() { return live_pool()->nodes; }
+  // 接管 rhs 的节点之前调用：把两棵树的内存池合并成一个
+  void adopt(AVL& rhs);
+
+  static int height(const Node* node) { return node ? node->height : 0; }
+  static int balance(const Node* node) { return height(node->left) - height(node->right); }
+  static std::size_t size(const Node* node) {
+    if constexpr (Policy::sized) return node ? node->size : 0;
+    else return 0;
+  }
+  static void update(Node* node) {
+    int l = height(node->left), r = height(node->right);
+    node->height = static_cast<std::int8_t>(1 + (l > r ? l : r));
+    if constexpr (Policy::sized) node->size = 1 + size(node->left) + size(node->right);
+  }
+  // 小于 key（inclusive 时为小于等于）的元素个数
+  std::size_t rank(const Key& key, bool inclusive) const;
+  static Node* rotate_left(Node* node);
+  static Node* rotate_right(Node* node);
+  static Node* rebalance(Node* node);
+
+  Node* insert(Node* node, const Key& key, const Value& value, bool& inserted);
+  Node* erase(Node* node, const Key& key, bool& erased);
+  static Node* detach_min(Node* node, Node*& min);
+
+  Node* clone(const Node* node);
+  void destroy(Node* node);
+
+  // 以 mid 为中间节点连接两棵树，要求 l < mid < r
+  static Node* join(Node* l, Node* mid, Node* r);
+  static Node* join_right(Node* l, Node* mid, Node* r);
+  static Node* join_left(Node* l, Node* mid, Node* r);
+  static Node* join2(Node* l, Node* r);
+  // 拆成 < key、== key（found，可能为空）、> key 三部分
+  void split(Node* node, const Key& key, Node*& l, Node*& found, Node*& r) const;
+  template <typename ForwardIt>
+  Node* build(ForwardIt& it, std::size_t n);
+
+  // 集合运算中被丢弃的节点。并行执行时各分支各自收集，结束后在调用线程统一归还给内存池，
+  // 因此 NodePool 不需要加锁。节点通过 left 串成链表。
+  struct Trash {
+    Node* head = nullptr;
+    Node* tail = nullptr;
+    std::size_t n = 0;
+    void push(Node* node) {
+      node->left = head;
+      if (!head) tail = node;
+      head = node;
+      ++n;
+    }
+    void push_tree(Node* node) {
+      if (!node) return;
+      push_tree(node->left);
+      push_tree(node->right);
+      push(node);
+    }
+    void append(Trash& rhs) {
+      if (!rhs.head) return;
+      rhs.tail->left = head;
+      if (!head) tail = rhs.tail;
+      head = rhs.head;
+      n += rhs.n;
+    }
+  };
+  enum class SetOp { unite, intersect, subtract };
+  Node* set_op(SetOp op, Node* a, Node* b, int depth, Trash& trash) const;
+  static AVL set_op(SetOp op, AVL& a, AVL& b, unsigned threads);
+  template <typename F>
+  static void walk(const Node* node, F& f) {
+    if (!node) return;
+    walk(node->left, f);
+    f(node->key, node->value);
+    walk(node->right, f);
+  }
+
+private:
+  Node* root = nullptr;
+  mutable std::size_t count = 0;
+  std::shared_ptr<Pool> pool;
+  Compare compare;
+};
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::rotate_left(Node* node) {
+  Node* r = node->right;
+  node->right = r->left;
+  r->left = node;
+  update(node);
+  update(r);
+
+  return r;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::rotate_right(Node* node) {
+  Node* l = node->left;
+  node->left = l->right;
+  l->right = node;
+  update(node);
+  update(l);
+
+  return l;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::rebalance(Node* node) {
+  update(node);
+  int b = balance(node);
+  if (b > 1) {
+    // LR 型先把左孩子左旋成 LL 型
+    if (balance(node->left) < 0) node->left = rotate_left(node->left);
+    return rotate_right(node);
+  }
+  if (b < -1) {
+    if (balance(node->right) > 0) node->right = rotate_right(node->right);
+    return rotate_left(node);
+  }
+
+  return node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::insert(Node* node, const Key& key,
+                                                                          const Value& value, bool& inserted) {
+  if (node == nullptr) {
+    inserted = true;
+    return nodes().create(key, value);
+  }
+
+  if (compare(key, node->key)) node->left = insert(node->left, key, value, inserted);
+  else if (compare(node->key, key)) node->right = insert(node->right, key, value, inserted);
+  else node->value = value;
+
+  return inserted ? rebalance(node) : node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+bool AVL<Key, Value, Compare, Policy>::insert(const Key& key, const Value& value) {
+  bool inserted = false;
+  root = insert(root, key, value, inserted);
+  if (inserted && count != unknown) ++count;
+
+  return inserted;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::detach_min(Node* node, Node*& min) {
+  if (!node->left) {
+    min = node;
+    return node->right;
+  }
+  node->left = detach_min(node->left, min);
+
+  return rebalance(node);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::erase(Node* node, const Key& key, bool& erased) {
+  if (node == nullptr) return nullptr;
+
+  if (compare(key, node->key)) {
+    node->left = erase(node->left, key, erased);
+  } else if (compare(node->key, key)) {
+    node->right = erase(node->right, key, erased);
+  } else {
+    erased = true;
+    Node* l = node->left;
+    Node* r = node->right;
+    nodes().destroy(node);
+    if (!r) return l;
+    // 用右子树的最小节点顶替被删节点，直接搬节点而不是拷贝键值
+    Node* min = nullptr;
+    r = detach_min(r, min);
+    min->left = l;
+    min->right = r;
+    return rebalance(min);
+  }
+
+  return erased ? rebalance(node) : node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+bool AVL<Key, Value, Compare, Policy>::erase(const Key& key) {
+  bool erased = false;
+  root = erase(root, key, erased);
+  if (erased && count != unknown) --count;
+
+  return erased;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+const Value* AVL<Key, Value, Compare, Policy>::find(const Key& key) const {
+  const Node* node = root;
+  while (node) {
+    if (compare(key, node->key)) node = node->left;
+    else if (compare(node->key, key)) node = node->right;
+    else return &node->value;
+  }
+
+  return nullptr;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+const typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::lower_bound(const Key& key) const {
+  const Node* node = root;
+  const Node* result = nullptr;
+  while (node) {
+    if (compare(node->key, key)) {
+      node = node->right;
+    } else {
+      result = node;
+      node = node->left;
+    }
+  }
+
+  return result;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+const typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::upper_bound(const Key& key) const {
+  const Node* node = root;
+  const Node* result = nullptr;
+  while (node) {
+    if (compare(key, node->key)) {
+      result = node;
+      node = node->left;
+    } else {
+      node = node->right;
+    }
+  }
+
+  return result;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::clone(const Node* node) {
+  if (!node) return nullptr;
+  Node* copy = nodes().create(node->key, node->value);
+  static_cast<typename Policy::node_data&>(*copy) = *node;
+  copy->height = node->height;
+  copy->left = clone(node->left);
+  copy->right = clone(node->right);
+
+  return copy;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+void AVL<Key, Value, Compare, Policy>::destroy(Node* node) {
+  if (!node) return;
+  destroy(node->left);
+  destroy(node->right);
+  nodes().destroy(node);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+template <typename ForwardIt>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::build(ForwardIt& it, std::size_t n) {
+  // 中序消费输入：先建左半，再取中间元素，再建右半
+  if (n == 0) return nullptr;
+  Node* l = build(it, n / 2);
+  Node* node = nodes().create(it->first, it->second);
+  ++it;
+  node->left = l;
+  node->right = build(it, n - n / 2 - 1);
+  update(node);
+
+  return node;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+template <typename ForwardIt>
+AVL<Key, Value, Compare, Policy> AVL<Key, Value, Compare, Policy>::from_sorted(ForwardIt first, ForwardIt last,
+                                                                               const Compare& cmp) {
+  AVL tree(cmp);
+  std::size_t n = std::distance(first, last);
+  tree.root = tree.build(first, n);
+  tree.count = n;
+
+  return tree;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::join_right(Node* l, Node* mid, Node* r) {
+  // l 比 r 高至少 2：沿 l 的右链下降到高度与 r 相当的位置挂上去，回溯时重新平衡
+  if (height(l->right) <= height(r) + 1) {
+    mid->left = l->right;
+    mid->right = r;
+    update(mid);
+    l->right = mid;
+  } else {
+    l->right = join_right(l->right, mid, r);
+  }
+
+  return rebalance(l);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::join_left(Node* l, Node* mid, Node* r) {
+  if (height(r->left) <= height(l) + 1) {
+    mid->left = l;
+    mid->right = r->left;
+    update(mid);
+    r->left = mid;
+  } else {
+    r->left = join_left(l, mid, r->left);
+  }
+
+  return rebalance(r);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::join(Node* l, Node* mid, Node* r) {
+  int hl = height(l), hr = height(r);
+  if (hl > hr + 1) return join_right(l, mid, r);
+  if (hr > hl + 1) return join_left(l, mid, r);
+  mid->left = l;
+  mid->right = r;
+  update(mid);
+
+  return mid;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::join2(Node* l, Node* r) {
+  if (!r) return l;
+  Node* min = nullptr;
+  r = detach_min(r, min);
+
+  return join(l, min, r);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+void AVL<Key, Value, Compare, Policy>::split(Node* node, const Key& key, Node*& l, Node*& found, Node*& r) const {
+  if (!node) {
+    l = found = r = nullptr;
+    return;
+  }
+
+  Node* left = node->left;
+  Node* right = node->right;
+  if (compare(key, node->key)) {
+    split(left, key, l, found, left);
+    r = join(left, node, right);
+  } else if (compare(node->key, key)) {
+    split(right, key, right, found, r);
+    l = join(left, node, right);
+  } else {
+    l = left;
+    r = right;
+    found = node;
+    found->left = found->right = nullptr;
+    update(found);
+  }
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+void AVL<Key, Value, Compare, Policy>::adopt(AVL& rhs) {
+  if (!rhs.pool) return;
+  const std::shared_ptr<Pool>& mine = live_pool();
+  const std::shared_ptr<Pool>& theirs = rhs.live_pool();
+  if (mine == theirs) return;
+  mine->nodes.absorb(theirs->nodes);
+  theirs->parent = mine;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+void AVL<Key, Value, Compare, Policy>::split(const Key& key, AVL& left, AVL& right) {
+  Node *l, *found, *r;
+  split(root, key, l, found, r);
+  if (found) r = join(nullptr, found, r);
+  root = nullptr;
+  count = 0;
+
+  left.clear();
+  right.clear();
+  left.adopt(*this);
+  right.adopt(*this);
+  left.root = l;
+  right.root = r;
+  left.count = Policy::sized ? tally(l) : unknown;
+  right.count = Policy::sized ? tally(r) : unknown;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+AVL<Key, Value, Compare, Policy> AVL<Key, Value, Compare, Policy>::join(AVL& left, const Key& key, const Value& value,
+                                                                        AVL& right) {
+  AVL tree(left.compare);
+  tree.adopt(left);
+  tree.adopt(right);
+  std::size_t n = left.count == unknown || right.count == unknown ? unknown : left.count + right.count + 1;
+  tree.root = join(left.root, tree.nodes().create(key, value), right.root);
+  tree.count = n;
+  left.root = right.root = nullptr;
+  left.count = right.count = 0;
+
+  return tree;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::set_op(SetOp op, Node* a, Node* b,
+                                                                                         int depth, Trash& trash) const {
+  if (!a || !b) {
+    if (op == SetOp::unite) return a ? a : b;
+    trash.push_tree(b);
+    if (op == SetOp::subtract) return a;
+    trash.push_tree(a);
+    return nullptr;
+  }
+
+  // 以 a 的根为界拆分 b，两侧递归，最后用 join 拼回去
+  Node* mid = a;
+  Node* al = a->left;
+  Node* ar = a->right;
+  Node *bl, *found, *br;
+  split(b, mid->key, bl, found, br);
+
+  Node *l, *r;
+  // 树高超过 12（至少几百个节点）才值得分叉，避免线程开销压过计算量
+  if (depth > 0 && height(a) > 12) {
+    Trash side;
+    auto left = std::async(std::launch::async, [&] { return set_op(op, al, bl, depth - 1, side); });
+    r = set_op(op, ar, br, depth - 1, trash);
+    l = left.get();
+    trash.append(side);
+  } else {
+    l = set_op(op, al, bl, depth, trash);
+    r = set_op(op, ar, br, depth, trash);
+  }
+
+  bool keep = op == SetOp::unite || (op == SetOp::intersect) == (found != nullptr);
+  if (found) trash.push(found);
+  if (keep) return join(l, mid, r);
+  trash.push(mid);
+  return join2(l, r);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+AVL<Key, Value, Compare, Policy> AVL<Key, Value, Compare, Policy>::set_op(SetOp op, AVL& a, AVL& b, unsigned threads) {
+  int depth = 0;
+  while ((1u << depth) < threads) ++depth;
+
+  AVL tree(a.compare);
+  tree.adopt(a);
+  tree.adopt(b);
+  std::size_t total = a.size() + b.size();
+  Trash trash;
+  tree.root = tree.set_op(op, a.root, b.root, depth, trash);
+  tree.count = total - trash.n;
+  a.root = b.root = nullptr;
+  a.count = b.count = 0;
+
+  // 被丢弃的节点在这里统一析构，归还到合并后的内存池
+  while (trash.head) {
+    Node* next = trash.head->left;
+    tree.nodes().destroy(trash.head);
+    trash.head = next;
+  }
+
+  return tree;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+AVL<Key, Value, Compare, Policy> AVL<Key, Value, Compare, Policy>::set_union(AVL a, AVL b, unsigned threads) {
+  return set_op(SetOp::unite, a, b, threads);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+AVL<Key, Value, Compare, Policy> AVL<Key, Value, Compare, Policy>::set_intersection(AVL a, AVL b, unsigned threads) {
+  return set_op(SetOp::intersect, a, b, threads);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+AVL<Key, Value, Compare, Policy> AVL<Key, Value, Compare, Policy>::set_difference(AVL a, AVL b, unsigned threads) {
+  return set_op(SetOp::subtract, a, b, threads);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+std::size_t AVL<Key, Value, Compare, Policy>::rank(const Key& key, bool inclusive) const {
+  static_assert(Policy::sized, "rank/select/count_range need avl_order_statistic");
+  const Node* node = root;
+  std::size_t r = 0;
+  while (node) {
+    bool go_right = inclusive ? !compare(key, node->key) : compare(node->key, key);
+    if (go_right) {
+      r += size(node->left) + 1;
+      node = node->right;
+    } else {
+      node = node->left;
+    }
+  }
+
+  return r;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+std::size_t AVL<Key, Value, Compare, Policy>::rank(const Key& key) const {
+  return rank(key, false);
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+const typename AVL<Key, Value, Compare, Policy>::Node* AVL<Key, Value, Compare, Policy>::select(std::size_t k) const {
+  static_assert(Policy::sized, "rank/select/count_range need avl_order_statistic");
+  const Node* node = root;
+  while (node) {
+    std::size_t l = size(node->left);
+    if (k < l) {
+      node = node->left;
+    } else if (k == l) {
+      return node;
+    } else {
+      k -= l + 1;
+      node = node->right;
+    }
+  }
+
+  return nullptr;
+}
+
+template <typename Key, typename Value, typename Compare, typename Policy>
+std::size_t AVL<Key, Value, Compare, Policy>::count_range(const Key& lo, const Key& hi) const {
+  if (compare(hi, lo)) return 0;
+  return rank(hi, true) - rank(lo, false);
+}
+
+#endif
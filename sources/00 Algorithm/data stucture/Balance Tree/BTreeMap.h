@@ -0,0 +1,582 @@
+#ifndef BTREE_MAP_H
+#define BTREE_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "../node_pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BTREE_MAP_X86 1
+#endif
+
+// B+ 树有序映射，接口与 AVL 的 insert/erase/find/contains/for_each 一致，可以直接替换。
+// 每个节点约 NodeBytes 字节（默认 512，建议 256 ~ 1024），一次下降覆盖几十个键，
+// 10^8 个键时树高只有 5 层左右，而 AVL 每层一次 cache miss、要 27 层。
+//   - 内部节点只存分隔键和孩子指针，child[i] 中的键 < keys[i] <= child[i + 1] 中的键；
+//   - 键值都在叶子里，叶子之间双向链接，范围扫描是顺序访问；
+//   - 节点内查找：Compare 为 std::less 的 int32_t / int64_t 键用 AVX2 一次比较 8 / 4 个键并计数，
+//     其余类型用无分支的二分查找（循环里只有条件传送）。
+// 插入时节点满了就一分为二，删除时节点不足半满就向兄弟借或与兄弟合并。
+// 节点来自两个 NodePool（叶子和内部节点各一个），数组槽位一直是构造好的对象，
+// 因此 Key 和 Value 需要可默认构造、可移动赋值。
+namespace btree_detail {
+
+// 第一个 !(keys[i] < key) 的下标
+template <typename Key, typename Compare>
+inline std::size_t lower_scalar(const Key* keys, std::size_t n, const Key& key, const Compare& compare) {
+  const Key* base = keys;
+  while (n > 1) {
+    std::size_t half = n / 2;
+    base = compare(base[half - 1], key) ? base + half : base;
+    n -= half;
+  }
+  return (base - keys) + (n == 1 && compare(*base, key));
+}
+
+// 第一个 key < keys[i] 的下标
+template <typename Key, typename Compare>
+inline std::size_t upper_scalar(const Key* keys, std::size_t n, const Key& key, const Compare& compare) {
+  const Key* base = keys;
+  while (n > 1) {
+    std::size_t half = n / 2;
+    base = compare(key, base[half - 1]) ? base : base + half;
+    n -= half;
+  }
+  return (base - keys) + (n == 1 && !compare(key, *base));
+}
+
+#ifdef BTREE_MAP_X86
+// 有序数组里 < key（Upper 时为 <= key）的元素个数就是 lower_bound（upper_bound）的下标
+#define BTREE_MAP_COUNT_KERNEL(TYPE, LANES, SET1, CMPGT)                                          \
+  template <bool Upper>                                                                           \
+  __attribute__((target("avx2"))) inline std::size_t count_avx2(const TYPE* keys, std::size_t n,  \
+                                                                TYPE key) {                       \
+    __m256i k = SET1(key);                                                                        \
+    std::size_t c = 0, i = 0;                                                                     \
+    for (; i + LANES <= n; i += LANES) {                                                          \
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));                 \
+      __m256i m = Upper ? CMPGT(v, k) : CMPGT(k, v);                                              \
+      int bits = __builtin_popcount(_mm256_movemask_epi8(m)) / (32 / LANES);                      \
+      c += Upper ? LANES - bits : bits;                                                           \
+    }                                                                                             \
+    for (; i < n; ++i) c += Upper ? keys[i] <= key : keys[i] < key;                               \
+    return c;                                                                                     \
+  }
+
+BTREE_MAP_COUNT_KERNEL(std::int32_t, 8, _mm256_set1_epi32, _mm256_cmpgt_epi32)
+BTREE_MAP_COUNT_KERNEL(std::int64_t, 4, _mm256_set1_epi64x, _mm256_cmpgt_epi64)
+
+#undef BTREE_MAP_COUNT_KERNEL
+
+inline bool has_avx2() {
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+}
+#endif
+
+template <typename Key, typename Compare>
+constexpr bool simd_searchable = std::is_same_v<Compare, std::less<Key>> &&
+                                 (std::is_same_v<Key, std::int32_t> || std::is_same_v<Key, std::int64_t>);
+
+template <typename Key, typename Compare>
+inline std::size_t lower(const Key* keys, std::size_t n, const Key& key, const Compare& compare) {
+#ifdef BTREE_MAP_X86
+  if constexpr (simd_searchable<Key, Compare>)
+    if (has_avx2()) return count_avx2<false>(keys, n, key);
+#endif
+  return lower_scalar(keys, n, key, compare);
+}
+
+template <typename Key, typename Compare>
+inline std::size_t upper(const Key* keys, std::size_t n, const Key& key, const Compare& compare) {
+#ifdef BTREE_MAP_X86
+  if constexpr (simd_searchable<Key, Compare>)
+    if (has_avx2()) return count_avx2<true>(keys, n, key);
+#endif
+  return upper_scalar(keys, n, key, compare);
+}
+
+}  // namespace btree_detail
+
+template <typename Key, typename Value, typename Compare = std::less<Key>, std::size_t NodeBytes = 512>
+class BTreeMap {
+  struct Base {
+    std::uint16_t n = 0;  // 键的个数
+    bool leaf;
+    explicit Base(bool leaf) : leaf(leaf) {}
+  };
+
+  static constexpr std::size_t fit(std::size_t bytes, std::size_t header, std::size_t per_item) {
+    return bytes > header + 4 * per_item ? (bytes - header) / per_item : 4;
+  }
+
+public:
+  // 容量由 NodeBytes 推出；键值太大时至少保留 4 个槽位
+  static constexpr std::size_t inner_cap = fit(NodeBytes, 2 * sizeof(void*), sizeof(Key) + sizeof(void*));
+  static constexpr std::size_t leaf_cap = fit(NodeBytes, 3 * sizeof(void*), sizeof(Key) + sizeof(Value));
+
+private:
+  static_assert(inner_cap < 65536 && leaf_cap < 65536, "NodeBytes too large");
+  static constexpr std::size_t inner_min = inner_cap / 2;
+  static constexpr std::size_t leaf_min = leaf_cap / 2;
+
+  struct alignas(64) Inner : Base {
+    Inner() : Base(false) {}
+    Key keys[inner_cap];
+    Base* child[inner_cap + 1];
+  };
+  struct alignas(64) Leaf : Base {
+    Leaf() : Base(true) {}
+    Key keys[leaf_cap];
+    Value values[leaf_cap];
+    Leaf* prev = nullptr;
+    Leaf* next = nullptr;
+  };
+
+public:
+  // 沿叶子链表前进的只读迭代器
+  class const_iterator {
+  public:
+    const_iterator() = default;
+    const Key& key() const { return leaf->keys[i]; }
+    const Value& value() const { return leaf->values[i]; }
+    std::pair<const Key&, const Value&> operator*() const { return {leaf->keys[i], leaf->values[i]}; }
+    const_iterator& operator++() {
+      if (++i == leaf->n) leaf = leaf->next, i = 0;
+      return *this;
+    }
+    bool operator==(const const_iterator& rhs) const { return leaf == rhs.leaf && i == rhs.i; }
+    bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+
+  private:
+    friend class BTreeMap;
+    const_iterator(const Leaf* leaf, std::size_t i) : leaf(leaf), i(i) {}
+    const Leaf* leaf = nullptr;
+    std::size_t i = 0;
+  };
+
+  BTreeMap(const Compare& cmp = Compare()) : compare(cmp) {}
+  BTreeMap(const BTreeMap& rhs) : compare(rhs.compare) {
+    Leaf* last = nullptr;
+    root = clone(rhs.root, last);
+    levels = rhs.levels;
+    count = rhs.count;
+  }
+  BTreeMap(BTreeMap&& rhs) noexcept
+      : root(rhs.root), head(rhs.head), levels(rhs.levels), count(rhs.count),
+        leaves(std::move(rhs.leaves)), inners(std::move(rhs.inners)), compare(rhs.compare) {
+    rhs.root = nullptr, rhs.head = nullptr, rhs.levels = 0, rhs.count = 0;
+  }
+  BTreeMap& operator=(BTreeMap rhs) noexcept {
+    clear();
+    std::swap(root, rhs.root);
+    std::swap(head, rhs.head);
+    std::swap(levels, rhs.levels);
+    std::swap(count, rhs.count);
+    std::swap(leaves, rhs.leaves);
+    std::swap(inners, rhs.inners);
+    std::swap(compare, rhs.compare);
+    return *this;
+  }
+  ~BTreeMap() { clear(); }
+
+  // 键已存在时覆盖 value 并返回 false
+  bool insert(const Key& key, const Value& value);
+  bool erase(const Key& key);
+
+  Value* find(const Key& key) { return const_cast<Value*>(static_cast<const BTreeMap*>(this)->find(key)); }
+  const Value* find(const Key& key) const;
+  bool contains(const Key& key) const { return find(key) != nullptr; }
+
+  const_iterator begin() const { return head ? const_iterator(head, 0) : end(); }
+  const_iterator end() const { return const_iterator(); }
+  // 第一个 >= key / > key 的位置
+  const_iterator lower_bound(const Key& key) const;
+  const_iterator upper_bound(const Key& key) const;
+
+  // 按键的顺序访问每个元素：f(key, value)
+  template <typename F>
+  void for_each(F f) const {
+    for (const Leaf* leaf = head; leaf; leaf = leaf->next)
+      for (std::size_t i = 0; i < leaf->n; ++i) f(leaf->keys[i], leaf->values[i]);
+  }
+
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  int height() const { return levels; }
+  void clear() {
+    destroy(root);
+    root = nullptr, head = nullptr, levels = 0, count = 0;
+  }
+
+private:
+  std::size_t lower(const Key* keys, std::size_t n, const Key& key) const {
+    return btree_detail::lower(keys, n, key, compare);
+  }
+  std::size_t upper(const Key* keys, std::size_t n, const Key& key) const {
+    return btree_detail::upper(keys, n, key, compare);
+  }
+  const Leaf* find_leaf(const Key& key) const;
+
+  // 返回 true 表示 node 分裂了：sep 为上推的分隔键，right 为新的右兄弟
+  bool insert(Base* node, const Key& key, const Value& value, bool& inserted, Key& sep, Base*& right);
+  void split_leaf(Leaf* leaf, std::size_t i, const Key& key, const Value& value, Key& sep, Base*& right);
+  void split_inner(Inner* node, Key& sep, Base*& right);
+  bool erase(Base* node, const Key& key);
+  // parent->child[i] 不足半满：向兄弟借一个，或与兄弟合并
+  void fix(Inner* parent, std::size_t i);
+  void merge(Inner* parent, std::size_t i);
+
+  Base* clone(const Base* node, Leaf*& last);
+  void destroy(Base* node);
+
+private:
+  Base* root = nullptr;
+  Leaf* head = nullptr;  // 最左的叶子
+  int levels = 0;
+  std::size_t count = 0;
+  NodePool<Leaf> leaves;
+  NodePool<Inner> inners;
+  Compare compare;
+};
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+const typename BTreeMap<Key, Value, Compare, NodeBytes>::Leaf* BTreeMap<Key, Value, Compare, NodeBytes>::find_leaf(
+    const Key& key) const {
+  const Base* node = root;
+  while (node && !node->leaf) {
+    const Inner* in = static_cast<const Inner*>(node);
+    node = in->child[upper(in->keys, in->n, key)];
+  }
+
+  return static_cast<const Leaf*>(node);
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+const Value* BTreeMap<Key, Value, Compare, NodeBytes>::find(const Key& key) const {
+  const Leaf* leaf = find_leaf(key);
+  if (!leaf) return nullptr;
+  std::size_t i = lower(leaf->keys, leaf->n, key);
+  if (i < leaf->n && !compare(key, leaf->keys[i])) return &leaf->values[i];
+
+  return nullptr;
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+typename BTreeMap<Key, Value, Compare, NodeBytes>::const_iterator BTreeMap<Key, Value, Compare, NodeBytes>::lower_bound(
+    const Key& key) const {
+  const Leaf* leaf = find_leaf(key);
+  if (!leaf) return end();
+  std::size_t i = lower(leaf->keys, leaf->n, key);
+  // 分隔键只是路由边界，目标可能是下一片叶子的第一个元素
+  if (i == leaf->n) return leaf->next ? const_iterator(leaf->next, 0) : end();
+
+  return const_iterator(leaf, i);
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+typename BTreeMap<Key, Value, Compare, NodeBytes>::const_iterator BTreeMap<Key, Value, Compare, NodeBytes>::upper_bound(
+    const Key& key) const {
+  const Leaf* leaf = find_leaf(key);
+  if (!leaf) return end();
+  std::size_t i = upper(leaf->keys, leaf->n, key);
+  if (i == leaf->n) return leaf->next ? const_iterator(leaf->next, 0) : end();
+
+  return const_iterator(leaf, i);
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+bool BTreeMap<Key, Value, Compare, NodeBytes>::insert(const Key& key, const Value& value) {
+  if (!root) {
+    Leaf* leaf = leaves.create();
+    leaf->keys[0] = key;
+    leaf->values[0] = value;
+    leaf->n = 1;
+    root = head = leaf;
+    levels = 1;
+    count = 1;
+    return true;
+  }
+
+  bool inserted = false;
+  Key sep;
+  Base* right = nullptr;
+  if (insert(root, key, value, inserted, sep, right)) {
+    // 根分裂，树长高一层
+    Inner* top = inners.create();
+    top->keys[0] = std::move(sep);
+    top->child[0] = root;
+    top->child[1] = right;
+    top->n = 1;
+    root = top;
+    ++levels;
+  }
+  if (inserted) ++count;
+
+  return inserted;
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+bool BTreeMap<Key, Value, Compare, NodeBytes>::insert(Base* node, const Key& key, const Value& value, bool& inserted,
+                                                      Key& sep, Base*& right) {
+  if (node->leaf) {
+    Leaf* leaf = static_cast<Leaf*>(node);
+    std::size_t i = lower(leaf->keys, leaf->n, key);
+    if (i < leaf->n && !compare(key, leaf->keys[i])) {
+      leaf->values[i] = value;
+      return false;
+    }
+    inserted = true;
+    if (leaf->n == leaf_cap) {
+      split_leaf(leaf, i, key, value, sep, right);
+      return true;
+    }
+    std::move_backward(leaf->keys + i, leaf->keys + leaf->n, leaf->keys + leaf->n + 1);
+    std::move_backward(leaf->values + i, leaf->values + leaf->n, leaf->values + leaf->n + 1);
+    leaf->keys[i] = key;
+    leaf->values[i] = value;
+    ++leaf->n;
+    return false;
+  }
+
+  Inner* in = static_cast<Inner*>(node);
+  std::size_t i = upper(in->keys, in->n, key);
+  Key child_sep;
+  Base* child_right = nullptr;
+  if (!insert(in->child[i], key, value, inserted, child_sep, child_right)) return false;
+
+  if (in->n == inner_cap) {
+    // 先分裂再把孩子上推的分隔键放进对应的一半
+    split_inner(in, sep, right);
+    Inner* target = in;
+    if (i > in->n) {
+      target = static_cast<Inner*>(right);
+      i -= in->n + 1;
+    }
+    in = target;
+    std::move_backward(in->keys + i, in->keys + in->n, in->keys + in->n + 1);
+    std::move_backward(in->child + i + 1, in->child + in->n + 1, in->child + in->n + 2);
+    in->keys[i] = std::move(child_sep);
+    in->child[i + 1] = child_right;
+    ++in->n;
+    return true;
+  }
+  std::move_backward(in->keys + i, in->keys + in->n, in->keys + in->n + 1);
+  std::move_backward(in->child + i + 1, in->child + in->n + 1, in->child + in->n + 2);
+  in->keys[i] = std::move(child_sep);
+  in->child[i + 1] = child_right;
+  ++in->n;
+
+  return false;
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+void BTreeMap<Key, Value, Compare, NodeBytes>::split_leaf(Leaf* leaf, std::size_t i, const Key& key,
+                                                          const Value& value, Key& sep, Base*& right) {
+  Leaf* r = leaves.create();
+  std::size_t mid = leaf->n / 2;
+  std::move(leaf->keys + mid, leaf->keys + leaf->n, r->keys);
+  std::move(leaf->values + mid, leaf->values + leaf->n, r->values);
+  r->n = static_cast<std::uint16_t>(leaf->n - mid);
+  leaf->n = static_cast<std::uint16_t>(mid);
+
+  r->next = leaf->next;
+  if (r->next) r->next->prev = r;
+  r->prev = leaf;
+  leaf->next = r;
+
+  Leaf* target = leaf;
+  if (i > mid) {
+    target = r;
+    i -= mid;
+  }
+  std::move_backward(target->keys + i, target->keys + target->n, target->keys + target->n + 1);
+  std::move_backward(target->values + i, target->values + target->n, target->values + target->n + 1);
+  target->keys[i] = key;
+  target->values[i] = value;
+  ++target->n;
+
+  sep = r->keys[0];
+  right = r;
+}
+
+// 中间的键上推到 sep，右半部分移到新节点；调用者随后把孩子的分隔键插入其中一半
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+void BTreeMap<Key, Value, Compare, NodeBytes>::split_inner(Inner* node, Key& sep, Base*& right) {
+  Inner* r = inners.create();
+  std::size_t mid = node->n / 2;
+  sep = std::move(node->keys[mid]);
+  std::move(node->keys + mid + 1, node->keys + node->n, r->keys);
+  std::copy(node->child + mid + 1, node->child + node->n + 1, r->child);
+  r->n = static_cast<std::uint16_t>(node->n - mid - 1);
+  node->n = static_cast<std::uint16_t>(mid);
+
+  right = r;
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+bool BTreeMap<Key, Value, Compare, NodeBytes>::erase(const Key& key) {
+  if (!root || !erase(root, key)) return false;
+  --count;
+
+  // 根只剩一个孩子时树变矮一层；最后一个元素删掉后树为空
+  if (!root->leaf && root->n == 0) {
+    Inner* old = static_cast<Inner*>(root);
+    root = old->child[0];
+    inners.destroy(old);
+    --levels;
+  } else if (root->leaf && root->n == 0) {
+    leaves.destroy(static_cast<Leaf*>(root));
+    root = head = nullptr;
+    levels = 0;
+  }
+
+  return true;
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+bool BTreeMap<Key, Value, Compare, NodeBytes>::erase(Base* node, const Key& key) {
+  if (node->leaf) {
+    Leaf* leaf = static_cast<Leaf*>(node);
+    std::size_t i = lower(leaf->keys, leaf->n, key);
+    if (i == leaf->n || compare(key, leaf->keys[i])) return false;
+    std::move(leaf->keys + i + 1, leaf->keys + leaf->n, leaf->keys + i);
+    std::move(leaf->values + i + 1, leaf->values + leaf->n, leaf->values + i);
+    --leaf->n;
+    return true;
+  }
+
+  // 分隔键不必等于某个现存的键，删除叶子里的键后不用修改上层
+  Inner* in = static_cast<Inner*>(node);
+  std::size_t i = upper(in->keys, in->n, key);
+  if (!erase(in->child[i], key)) return false;
+  Base* child = in->child[i];
+  if (child->n < (child->leaf ? leaf_min : inner_min)) fix(in, i);
+
+  return true;
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+void BTreeMap<Key, Value, Compare, NodeBytes>::fix(Inner* parent, std::size_t i) {
+  Base* child = parent->child[i];
+  Base* left = i > 0 ? parent->child[i - 1] : nullptr;
+  Base* right = i < parent->n ? parent->child[i + 1] : nullptr;
+  std::size_t min = child->leaf ? leaf_min : inner_min;
+
+  if (left && left->n > min) {
+    if (child->leaf) {
+      Leaf* c = static_cast<Leaf*>(child);
+      Leaf* l = static_cast<Leaf*>(left);
+      std::move_backward(c->keys, c->keys + c->n, c->keys + c->n + 1);
+      std::move_backward(c->values, c->values + c->n, c->values + c->n + 1);
+      c->keys[0] = std::move(l->keys[l->n - 1]);
+      c->values[0] = std::move(l->values[l->n - 1]);
+      parent->keys[i - 1] = c->keys[0];
+    } else {
+      // 父节点的分隔键下移，左兄弟的最后一个键上移
+      Inner* c = static_cast<Inner*>(child);
+      Inner* l = static_cast<Inner*>(left);
+      std::move_backward(c->keys, c->keys + c->n, c->keys + c->n + 1);
+      std::move_backward(c->child, c->child + c->n + 1, c->child + c->n + 2);
+      c->keys[0] = std::move(parent->keys[i - 1]);
+      c->child[0] = l->child[l->n];
+      parent->keys[i - 1] = std::move(l->keys[l->n - 1]);
+    }
+    ++child->n, --left->n;
+  } else if (right && right->n > min) {
+    if (child->leaf) {
+      Leaf* c = static_cast<Leaf*>(child);
+      Leaf* r = static_cast<Leaf*>(right);
+      c->keys[c->n] = std::move(r->keys[0]);
+      c->values[c->n] = std::move(r->values[0]);
+      std::move(r->keys + 1, r->keys + r->n, r->keys);
+      std::move(r->values + 1, r->values + r->n, r->values);
+      parent->keys[i] = r->keys[0];
+    } else {
+      Inner* c = static_cast<Inner*>(child);
+      Inner* r = static_cast<Inner*>(right);
+      c->keys[c->n] = std::move(parent->keys[i]);
+      c->child[c->n + 1] = r->child[0];
+      parent->keys[i] = std::move(r->keys[0]);
+      std::move(r->keys + 1, r->keys + r->n, r->keys);
+      std::copy(r->child + 1, r->child + r->n + 1, r->child);
+    }
+    ++child->n, --right->n;
+  } else {
+    merge(parent, left ? i - 1 : i);
+  }
+}
+
+// 把 parent->child[i + 1] 并入 parent->child[i]，两者合计不超过一个节点的容量
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+void BTreeMap<Key, Value, Compare, NodeBytes>::merge(Inner* parent, std::size_t i) {
+  Base* left = parent->child[i];
+  Base* right = parent->child[i + 1];
+  if (left->leaf) {
+    Leaf* l = static_cast<Leaf*>(left);
+    Leaf* r = static_cast<Leaf*>(right);
+    std::move(r->keys, r->keys + r->n, l->keys + l->n);
+    std::move(r->values, r->values + r->n, l->values + l->n);
+    l->n += r->n;
+    l->next = r->next;
+    if (l->next) l->next->prev = l;
+    leaves.destroy(r);
+  } else {
+    Inner* l = static_cast<Inner*>(left);
+    Inner* r = static_cast<Inner*>(right);
+    l->keys[l->n] = std::move(parent->keys[i]);
+    std::move(r->keys, r->keys + r->n, l->keys + l->n + 1);
+    std::copy(r->child, r->child + r->n + 1, l->child + l->n + 1);
+    l->n += r->n + 1;
+    inners.destroy(r);
+  }
+  std::move(parent->keys + i + 1, parent->keys + parent->n, parent->keys + i);
+  std::copy(parent->child + i + 2, parent->child + parent->n + 1, parent->child + i + 1);
+  --parent->n;
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+typename BTreeMap<Key, Value, Compare, NodeBytes>::Base* BTreeMap<Key, Value, Compare, NodeBytes>::clone(
+    const Base* node, Leaf*& last) {
+  if (!node) return nullptr;
+  if (node->leaf) {
+    const Leaf* src = static_cast<const Leaf*>(node);
+    Leaf* copy = leaves.create();
+    std::copy(src->keys, src->keys + src->n, copy->keys);
+    std::copy(src->values, src->values + src->n, copy->values);
+    copy->n = src->n;
+    // 按中序克隆，叶子链表顺便接起来
+    copy->prev = last;
+    if (last) last->next = copy;
+    else head = copy;
+    last = copy;
+    return copy;
+  }
+
+  const Inner* src = static_cast<const Inner*>(node);
+  Inner* copy = inners.create();
+  std::copy(src->keys, src->keys + src->n, copy->keys);
+  for (std::size_t i = 0; i <= src->n; ++i) copy->child[i] = clone(src->child[i], last);
+  copy->n = src->n;
+
+  return copy;
+}
+
+template <typename Key, typename Value, typename Compare, std::size_t NodeBytes>
+void BTreeMap<Key, Value, Compare, NodeBytes>::destroy(Base* node) {
+  if (!node) return;
+  if (node->leaf) {
+    leaves.destroy(static_cast<Leaf*>(node));
+    return;
+  }
+  Inner* in = static_cast<Inner*>(node);
+  for (std::size_t i = 0; i <= in->n; ++i) destroy(in->child[i]);
+  inners.destroy(in);
+}
+
+#endif
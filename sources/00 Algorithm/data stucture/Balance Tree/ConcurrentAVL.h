@@ -0,0 +1,523 @@
+#ifndef CONCURRENT_AVL_H
+#define CONCURRENT_AVL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "../epoch.h"
+
+// 并发 AVL 有序映射，算法来自 Bronson et al.,
+// "A Practical Concurrent Binary Search Tree" (PPoPP 2010)。
+//
+// 读者不加锁：每个节点带一个版本号，节点在旋转中“缩小”（它的某棵子树被移走）
+// 时版本号先置 shrinking 位、结束后加一。读者下降时记下父节点的版本，
+// 读到孩子并记下孩子的版本后再验证父节点版本未变，验证失败只需从父节点重试（hand-over-hand）。
+// 写者只锁住被修改的几个节点：插入锁父节点，删除锁父节点和自己，
+// 旋转锁父节点、旋转点及其参与旋转的孩子；加锁顺序总是自上而下，不会死锁。
+// 有两个孩子的节点被删除时只把 value 置空（路由节点），等它少于两个孩子时再摘除，
+// 平衡修复沿 parent 指针向上进行。并发修改时各线程读到的高度可能已经过时，
+// 树会短暂地偏离严格的 AVL 条件；每个修改返回前都会修完自己造成的失衡，
+// 没有并发修改时，每次操作结束后树都满足严格的 AVL 条件，高度也都是准确的。
+//
+// 摘下的节点和被覆盖的 value 交给 EpochDomain，等所有可能持有它们的读者离开后再释放。
+// 所有公开操作都可以在任意线程上并发调用；析构时不能再有并发访问。
+// Key 需要可默认构造（根哨兵节点使用）。
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class ConcurrentAVL {
+public:
+  ConcurrentAVL(const Compare& cmp = Compare()) : holder(Key(), nullptr, nullptr), compare(cmp) {}
+  ConcurrentAVL(const ConcurrentAVL&) = delete;
+  ConcurrentAVL& operator=(const ConcurrentAVL&) = delete;
+  ~ConcurrentAVL() { destroy(holder.child[1].load(std::memory_order_relaxed)); }
+
+  // 键已存在时覆盖 value 并返回 false
+  bool insert(const Key& key, const Value& value);
+  bool erase(const Key& key);
+
+  // 返回 value 的拷贝：读者不持有任何锁，不能把节点内部的引用交给调用者
+  std::optional<Value> find(const Key& key) const;
+  bool contains(const Key& key) const;
+
+  // 并发修改时只是一个近似值
+  std::size_t size() const { return count.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+
+private:
+  // 按 cache line 对齐，小键时每个节点恰好占一行，下降一层最多一次缺失
+  struct alignas(64) Node {
+    Node(const Key& key, Value* value, Node* parent) : key(key), value(value), parent(parent) {}
+
+    // 自旋锁，满足 BasicLockable，可以直接交给 std::lock_guard
+    void lock() {
+      while (locked.exchange(true, std::memory_order_acquire))
+        while (locked.load(std::memory_order_relaxed)) std::this_thread::yield();
+    }
+    void unlock() { locked.store(false, std::memory_order_release); }
+
+    // 读路径用到的字段放在前面
+    const Key key;
+    std::atomic<std::uint64_t> version{0};
+    std::atomic<Node*> child[2] = {nullptr, nullptr};
+    std::atomic<Value*> value;  // nullptr 表示路由节点（逻辑上不存在）
+    std::atomic<Node*> parent;
+    std::atomic<int> height{1};
+    std::atomic<bool> locked{false};
+  };
+  using Lock = std::lock_guard<Node>;
+
+  // version 的低两位是状态位，其余是计数
+  static constexpr std::uint64_t unlinked = 1;
+  static constexpr std::uint64_t shrinking = 2;
+  static constexpr std::uint64_t shrink_step = 4;
+
+  enum class Result { absent, present, retry };
+  // node_condition() 的特殊返回值，其余返回值是节点应有的高度
+  static constexpr int unlink_required = -1;
+  static constexpr int rebalance_required = -2;
+  static constexpr int nothing_required = -3;
+
+  static bool is_changing(std::uint64_t ovl) { return ovl & (unlinked | shrinking); }
+  static bool is_unlinked(std::uint64_t ovl) { return ovl & unlinked; }
+  static int height(const Node* node) { return node ? node->height.load(std::memory_order_relaxed) : 0; }
+  // 0 / 1 对应 child 的下标，-1 表示相等
+  int dir(const Key& key, const Node* node) const {
+    if (compare(key, node->key)) return 0;
+    if (compare(node->key, key)) return 1;
+    return -1;
+  }
+  static void wait_until_not_changing(const Node* node) {
+    for (int spin = 0; node->version.load() & shrinking; ++spin)
+      if (spin > 64) std::this_thread::yield();
+  }
+
+  Result attempt_get(const Key& key, const Node* node, int d, std::uint64_t node_ovl,
+                     std::optional<Value>& out) const;
+  // value 为 nullptr 时表示删除，返回更新前是否存在该键
+  bool update(const Key& key, Value* value);
+  Result attempt_update(const Key& key, Value* value, Node* parent, Node* node, std::uint64_t node_ovl);
+  Result attempt_node_update(Value* value, Node* parent, Node* node);
+  bool attempt_unlink_nl(Node* parent, Node* node);
+
+  int node_condition(const Node* node) const;
+  Node* fix_height_nl(Node* node);
+  void fix_height_and_rebalance(Node* node);
+  Node* rebalance_nl(Node* parent, Node* node);
+  // d 是偏高的一侧：0 表示左高，需要向右旋
+  Node* rebalance_to_nl(Node* parent, Node* node, int d, Node* c, int h_far0);
+  Node* rotate_nl(Node* parent, Node* node, int d, Node* c, int h_far, int h_cc, Node* cf, int h_cf);
+  Node* double_rotate_nl(Node* parent, Node* node, int d, Node* c, int h_far, int h_cc, Node* cf, int h_cfc);
+
+  void retire(Node* node) { epochs.retire(node); }
+  void retire(Value* value) {
+    if (value) epochs.retire(value);
+  }
+  static void destroy(Node* node);
+
+private:
+  Node holder;  // 根哨兵，真正的根是 holder.child[1]
+  std::atomic<std::size_t> count{0};
+  mutable EpochDomain epochs;
+  Compare compare;
+};
+
+template <typename Key, typename Value, typename Compare>
+std::optional<Value> ConcurrentAVL<Key, Value, Compare>::find(const Key& key) const {
+  auto guard = epochs.pin();
+  while (true) {
+    const Node* right = holder.child[1].load();
+    if (!right) return std::nullopt;
+    int d = dir(key, right);
+    if (d < 0) {
+      Value* v = right->value.load();
+      return v ? std::optional<Value>(*v) : std::nullopt;
+    }
+    std::uint64_t ovl = right->version.load();
+    if (is_changing(ovl)) {
+      wait_until_not_changing(right);
+    } else if (right == holder.child[1].load()) {
+      std::optional<Value> out;
+      if (attempt_get(key, right, d, ovl, out) != Result::retry) return out;
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Compare>
+bool ConcurrentAVL<Key, Value, Compare>::contains(const Key& key) const {
+  return find(key).has_value();
+}
+
+// 在 node 的 d 侧子树中查找。node 的版本一旦偏离 node_ovl，说明 node 在旋转中缩小过，
+// 要找的键可能已经不在这棵子树里，交给上一层重试
+template <typename Key, typename Value, typename Compare>
+typename ConcurrentAVL<Key, Value, Compare>::Result ConcurrentAVL<Key, Value, Compare>::attempt_get(
+    const Key& key, const Node* node, int d, std::uint64_t node_ovl, std::optional<Value>& out) const {
+  while (true) {
+    const Node* child = node->child[d].load();
+    if (!child) {
+      if (node->version.load() != node_ovl) return Result::retry;
+      return Result::absent;
+    }
+    int cd = dir(key, child);
+    if (cd < 0) {
+      Value* v = child->value.load();
+      if (!v) return Result::absent;
+      out = *v;
+      return Result::present;
+    }
+    std::uint64_t child_ovl = child->version.load();
+    if (is_changing(child_ovl)) {
+      wait_until_not_changing(child);
+      if (node->version.load() != node_ovl) return Result::retry;
+    } else if (child != node->child[d].load()) {
+      if (node->version.load() != node_ovl) return Result::retry;
+    } else {
+      if (node->version.load() != node_ovl) return Result::retry;
+      Result r = attempt_get(key, child, cd, child_ovl, out);
+      if (r != Result::retry) return r;
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Compare>
+bool ConcurrentAVL<Key, Value, Compare>::insert(const Key& key, const Value& value) {
+  Value* fresh = new Value(value);
+  bool existed = update(key, fresh);
+  if (!existed) count.fetch_add(1, std::memory_order_relaxed);
+  return !existed;
+}
+
+template <typename Key, typename Value, typename Compare>
+bool ConcurrentAVL<Key, Value, Compare>::erase(const Key& key) {
+  bool existed = update(key, nullptr);
+  if (existed) count.fetch_sub(1, std::memory_order_relaxed);
+  return existed;
+}
+
+template <typename Key, typename Value, typename Compare>
+bool ConcurrentAVL<Key, Value, Compare>::update(const Key& key, Value* value) {
+  auto guard = epochs.pin();
+  while (true) {
+    Node* right = holder.child[1].load();
+    if (!right) {
+      if (!value) return false;
+      Lock lock(holder);
+      if (!holder.child[1].load()) {
+        holder.child[1].store(new Node(key, value, &holder));
+        holder.height.store(2, std::memory_order_relaxed);
+        return false;
+      }
+    } else {
+      std::uint64_t ovl = right->version.load();
+      if (is_changing(ovl)) {
+        wait_until_not_changing(right);
+      } else if (right == holder.child[1].load()) {
+        Result r = attempt_update(key, value, &holder, right, ovl);
+        if (r != Result::retry) return r == Result::present;
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Compare>
+typename ConcurrentAVL<Key, Value, Compare>::Result ConcurrentAVL<Key, Value, Compare>::attempt_update(
+    const Key& key, Value* value, Node* parent, Node* node, std::uint64_t node_ovl) {
+  int d = dir(key, node);
+  if (d < 0) return attempt_node_update(value, parent, node);
+
+  while (true) {
+    Node* child = node->child[d].load();
+    if (node->version.load() != node_ovl) return Result::retry;
+    if (!child) {
+      if (!value) return Result::absent;
+      Node* damaged;
+      {
+        Lock lock(*node);
+        if (node->version.load() != node_ovl) return Result::retry;
+        if (node->child[d].load()) continue;  // 有人抢先插入了孩子，重新读
+        node->child[d].store(new Node(key, value, node));
+        damaged = fix_height_nl(node);
+      }
+      fix_height_and_rebalance(damaged);
+      return Result::absent;
+    }
+    std::uint64_t child_ovl = child->version.load();
+    if (is_changing(child_ovl)) {
+      wait_until_not_changing(child);
+    } else if (child == node->child[d].load()) {
+      if (node->version.load() != node_ovl) return Result::retry;
+      Result r = attempt_update(key, value, node, child, child_ovl);
+      if (r != Result::retry) return r;
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Compare>
+typename ConcurrentAVL<Key, Value, Compare>::Result ConcurrentAVL<Key, Value, Compare>::attempt_node_update(
+    Value* value, Node* parent, Node* node) {
+  if (!value) {
+    if (!node->value.load()) return Result::absent;
+    if (!node->child[0].load() || !node->child[1].load()) {
+      // 至多一个孩子：直接摘除，需要先锁父节点
+      Node* damaged;
+      {
+        Lock parent_lock(*parent);
+        if (is_unlinked(parent->version.load()) || node->parent.load() != parent) return Result::retry;
+        {
+          Lock lock(*node);
+          if (!node->value.load()) return Result::absent;
+          if (!attempt_unlink_nl(parent, node)) return Result::retry;
+        }
+        damaged = fix_height_nl(parent);
+      }
+      fix_height_and_rebalance(damaged);
+      return Result::present;
+    }
+  }
+
+  Lock lock(*node);
+  if (is_unlinked(node->version.load())) return Result::retry;
+  // 删除时节点在加锁前失去了孩子，改走摘除的路径
+  if (!value && (!node->child[0].load() || !node->child[1].load())) return Result::retry;
+  Value* prev = node->value.exchange(value);
+  retire(prev);
+  return prev ? Result::present : Result::absent;
+}
+
+// 调用者持有 parent 和 node 的锁
+template <typename Key, typename Value, typename Compare>
+bool ConcurrentAVL<Key, Value, Compare>::attempt_unlink_nl(Node* parent, Node* node) {
+  Node* parent_left = parent->child[0].load();
+  Node* parent_right = parent->child[1].load();
+  if (parent_left != node && parent_right != node) return false;
+  Node* left = node->child[0].load();
+  Node* right = node->child[1].load();
+  if (left && right) return false;
+
+  Node* splice = left ? left : right;
+  parent->child[parent_left == node ? 0 : 1].store(splice);
+  if (splice) splice->parent.store(parent);
+  node->version.store(unlinked);
+  retire(node->value.exchange(nullptr));
+  retire(node);
+  return true;
+}
+
+template <typename Key, typename Value, typename Compare>
+int ConcurrentAVL<Key, Value, Compare>::node_condition(const Node* node) const {
+  const Node* left = node->child[0].load();
+  const Node* right = node->child[1].load();
+  if ((!left || !right) && !node->value.load()) return unlink_required;
+
+  int h = node->height.load(std::memory_order_relaxed);
+  int hl = height(left), hr = height(right);
+  int repl = 1 + std::max(hl, hr);
+  int bal = hl - hr;
+  if (bal < -1 || bal > 1) return rebalance_required;
+  return h != repl ? repl : nothing_required;
+}
+
+// 修正 node 的高度，返回下一个需要处理的节点：需要旋转或摘除时返回 node 本身
+template <typename Key, typename Value, typename Compare>
+typename ConcurrentAVL<Key, Value, Compare>::Node* ConcurrentAVL<Key, Value, Compare>::fix_height_nl(Node* node) {
+  int c = node_condition(node);
+  switch (c) {
+    case rebalance_required:
+    case unlink_required:
+      return node;
+    case nothing_required:
+      return nullptr;
+    default:
+      node->height.store(c, std::memory_order_relaxed);
+      return node->parent.load();
+  }
+}
+
+// 旋转之后 rebalance_nl 可能返回比 parent 更低的节点（旋转下去的节点，或重试时的孩子），
+// 这时 parent 子树里从返回的节点到 parent 之间都可能留有过时的高度或失衡。
+// 记下 parent 为 stop_at：修到这里之前遇到不需要处理的节点也不停下，继续沿 parent 向上检查
+template <typename Key, typename Value, typename Compare>
+void ConcurrentAVL<Key, Value, Compare>::fix_height_and_rebalance(Node* node) {
+  Node* stop_at = nullptr;
+  while (node && node->parent.load()) {
+    if (is_unlinked(node->version.load())) {
+      // 被别的线程摘除了，它会负责修复自己造成的损伤
+      if (!stop_at || is_unlinked(stop_at->version.load())) return;
+      node = stop_at;
+    }
+    int c = node_condition(node);
+    if (node == stop_at) stop_at = nullptr;
+    if (c == nothing_required) {
+      if (!stop_at) return;
+      node = node->parent.load();
+    } else if (c != unlink_required && c != rebalance_required) {
+      Lock lock(*node);
+      if (Node* next = fix_height_nl(node)) node = next;
+    } else {
+      Node* parent = node->parent.load();
+      Lock parent_lock(*parent);
+      if (!is_unlinked(parent->version.load()) && node->parent.load() == parent) {
+        Lock lock(*node);
+        Node* next = rebalance_nl(parent, node);
+        if (next != parent && next != parent->parent.load() && !stop_at) stop_at = parent;
+        // 返回空说明 node 和 parent 都不需要再处理，从 parent 继续向上
+        node = next ? next : parent;
+      }
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Compare>
+typename ConcurrentAVL<Key, Value, Compare>::Node* ConcurrentAVL<Key, Value, Compare>::rebalance_nl(Node* parent,
+                                                                                                   Node* node) {
+  Node* left = node->child[0].load();
+  Node* right = node->child[1].load();
+  if ((!left || !right) && !node->value.load()) {
+    if (attempt_unlink_nl(parent, node)) return fix_height_nl(parent);
+    return node;
+  }
+
+  int h = node->height.load(std::memory_order_relaxed);
+  int hl = height(left), hr = height(right);
+  int repl = 1 + std::max(hl, hr);
+  int bal = hl - hr;
+  if (bal > 1) return rebalance_to_nl(parent, node, 0, left, hr);
+  if (bal < -1) return rebalance_to_nl(parent, node, 1, right, hl);
+  if (repl != h) {
+    node->height.store(repl, std::memory_order_relaxed);
+    return fix_height_nl(parent);
+  }
+  return nullptr;
+}
+
+// c 是 node 偏高一侧的孩子，h_far0 是另一侧的高度。
+// cc 是 c 同侧的孩子，cf 是 c 朝向另一侧的孩子；cf 更高时需要双旋
+template <typename Key, typename Value, typename Compare>
+typename ConcurrentAVL<Key, Value, Compare>::Node* ConcurrentAVL<Key, Value, Compare>::rebalance_to_nl(
+    Node* parent, Node* node, int d, Node* c, int h_far0) {
+  Lock lock(*c);
+  int hc = c->height.load(std::memory_order_relaxed);
+  if (hc - h_far0 <= 1) return node;  // 加锁前已被别人修好，重新检查 node
+
+  Node* cf = c->child[1 - d].load();
+  int h_cc0 = height(c->child[d].load());
+  int h_cf0 = height(cf);
+  if (h_cc0 >= h_cf0) return rotate_nl(parent, node, d, c, h_far0, h_cc0, cf, h_cf0);
+
+  {
+    Lock cf_lock(*cf);
+    int h_cf = cf->height.load(std::memory_order_relaxed);
+    if (h_cc0 >= h_cf) return rotate_nl(parent, node, d, c, h_far0, h_cc0, cf, h_cf);
+    int h_cfc = height(cf->child[d].load());
+    int b = h_cc0 - h_cfc;
+    if (b >= -1 && b <= 1)
+      return double_rotate_nl(parent, node, d, c, h_far0, h_cc0, cf, h_cfc);
+  }
+  // 双旋后 c 仍会失衡，先把 c 向反方向旋转
+  return rebalance_to_nl(node, c, 1 - d, cf, h_cc0);
+}
+
+// 单旋：c 上升到 node 的位置，cf 改挂到 node 的 d 侧。node 在此期间处于 shrinking 状态
+template <typename Key, typename Value, typename Compare>
+typename ConcurrentAVL<Key, Value, Compare>::Node* ConcurrentAVL<Key, Value, Compare>::rotate_nl(
+    Node* parent, Node* node, int d, Node* c, int h_far, int h_cc, Node* cf, int h_cf) {
+  std::uint64_t ovl = node->version.load();
+  int side = parent->child[0].load() == node ? 0 : 1;
+
+  node->version.store(ovl | shrinking);
+
+  node->child[d].store(cf);
+  if (cf) cf->parent.store(node);
+  c->child[1 - d].store(node);
+  node->parent.store(c);
+  parent->child[side].store(c);
+  c->parent.store(parent);
+
+  int h_node = 1 + std::max(h_cf, h_far);
+  node->height.store(h_node, std::memory_order_relaxed);
+  c->height.store(1 + std::max(h_cc, h_node), std::memory_order_relaxed);
+
+  node->version.store(ovl + shrink_step);
+
+  // 旋转之后可能仍有节点需要修复，返回最靠下的那个
+  int bal_node = h_cf - h_far;
+  if (bal_node < -1 || bal_node > 1) return node;
+  if ((!cf || h_far == 0) && !node->value.load()) return node;
+  int bal_c = h_cc - h_node;
+  if (bal_c < -1 || bal_c > 1) return c;
+  if (h_cc == 0 && !c->value.load()) return c;
+  return fix_height_nl(parent);
+}
+
+// 双旋：cf 上升到 node 的位置，c 和 node 分别成为它的两个孩子
+template <typename Key, typename Value, typename Compare>
+typename ConcurrentAVL<Key, Value, Compare>::Node* ConcurrentAVL<Key, Value, Compare>::double_rotate_nl(
+    Node* parent, Node* node, int d, Node* c, int h_far, int h_cc, Node* cf, int h_cfc) {
+  std::uint64_t node_ovl = node->version.load();
+  std::uint64_t c_ovl = c->version.load();
+  int side = parent->child[0].load() == node ? 0 : 1;
+  Node* cfc = cf->child[d].load();
+  Node* cff = cf->child[1 - d].load();
+  int h_cff = height(cff);
+
+  node->version.store(node_ovl | shrinking);
+  c->version.store(c_ovl | shrinking);
+
+  node->child[d].store(cff);
+  if (cff) cff->parent.store(node);
+  c->child[1 - d].store(cfc);
+  if (cfc) cfc->parent.store(c);
+  cf->child[d].store(c);
+  c->parent.store(cf);
+  cf->child[1 - d].store(node);
+  node->parent.store(cf);
+  parent->child[side].store(cf);
+  cf->parent.store(parent);
+
+  int h_node = 1 + std::max(h_cff, h_far);
+  node->height.store(h_node, std::memory_order_relaxed);
+  int h_c = 1 + std::max(h_cc, h_cfc);
+  c->height.store(h_c, std::memory_order_relaxed);
+  cf->height.store(1 + std::max(h_c, h_node), std::memory_order_relaxed);
+
+  node->version.store(node_ovl + shrink_step);
+  c->version.store(c_ovl + shrink_step);
+
+  // 路由节点 c 旋转后少了一个孩子：趁还持有 cf 和 c 的锁直接摘除，
+  // 否则它与 node 是兄弟，沿 parent 向上的修复路径不会经过它
+  if ((h_cc == 0 || h_cfc == 0) && !c->value.load() && attempt_unlink_nl(cf, c)) {
+    h_c = std::max(h_cc, h_cfc);
+    cf->height.store(1 + std::max(h_c, h_node), std::memory_order_relaxed);
+  }
+
+  int bal_node = h_cff - h_far;
+  if (bal_node < -1 || bal_node > 1) return node;
+  if ((!cff || h_far == 0) && !node->value.load()) return node;
+  int bal_cf = h_c - h_node;
+  if (bal_cf < -1 || bal_cf > 1) return cf;
+  return fix_height_nl(parent);
+}
+
+template <typename Key, typename Value, typename Compare>
+void ConcurrentAVL<Key, Value, Compare>::destroy(Node* node) {
+  // 沿右旋把左子树转到右边，不用递归也不用栈
+  while (node) {
+    Node* left = node->child[0].load(std::memory_order_relaxed);
+    if (left) {
+      node->child[0].store(left->child[1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      left->child[1].store(node, std::memory_order_relaxed);
+      node = left;
+    } else {
+      Node* right = node->child[1].load(std::memory_order_relaxed);
+      delete node->value.load(std::memory_order_relaxed);
+      delete node;
+      node = right;
+    }
+  }
+}
+
+#endif
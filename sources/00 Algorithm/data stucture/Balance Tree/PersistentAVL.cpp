@@ -0,0 +1,39 @@
+#include <chrono>
+#include <future>
+#include <iostream>
+#include "AVL.h"
+#include "PersistentAVL.h"
+
+int main() {
+  const int n = 1000000;
+  AVL<int, int> plain;
+  PersistentAVL<int, int> index;
+  for (int i = 0; i < n; ++i) {
+    plain.insert(i, i);
+    index.insert(i, i);
+  }
+
+  // 完整拷贝 vs O(1) 快照
+  auto start = std::chrono::steady_clock::now();
+  AVL<int, int> copy(plain);
+  std::chrono::duration<double, std::milli> copy_ms = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  PersistentAVL<int, int> snapshot = index.snapshot();
+  std::chrono::duration<double, std::milli> snap_ms = std::chrono::steady_clock::now() - start;
+  std::cout << "AVL copy: " << copy_ms.count() << " ms, snapshot: " << snap_ms.count() << " ms" << std::endl;
+
+  // 后台线程导出快照，前台继续写入
+  std::future<long long> exported = std::async(std::launch::async, [snapshot] {
+    long long sum = 0;
+    snapshot.for_each([&sum](int, int v) { sum += v; });
+    return sum;
+  });
+  for (int i = 0; i < n; i += 2) index.erase(i);
+  for (int i = n; i < n + 1000; ++i) index.insert(i, i);
+
+  std::cout << "exported sum: " << exported.get() << " (snapshot size " << snapshot.size() << ")" << std::endl;
+  std::cout << "live size: " << index.size() << ", find 2 in live: " << (index.find(2) ? "yes" : "no")
+            << ", in snapshot: " << *snapshot.find(2) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,255 @@
+#ifndef PERSISTENT_AVL_H
+#define PERSISTENT_AVL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+// 持久化（路径复制）AVL 有序映射。
+// 节点带引用计数，可以同时属于多个版本。拷贝一个 PersistentAVL（或调用 snapshot()）
+// 只是让根的引用计数加一，O(1)；之后 insert/erase 自根向下只复制被共享的那条路径，
+// 产生一个新的根，旧版本看到的节点一个也不会被修改，每次修改额外占用 O(log n) 个节点。
+// 路径上的节点如果只被当前版本引用（引用计数为 1），就原地修改，没有快照时不会产生任何复制。
+// 引用计数降到 0 的节点连同它独占的子树一起释放。
+//
+// 不同的 PersistentAVL 对象（哪怕共享节点）可以在不同线程上同时读写；
+// 同一个对象不能被多个线程同时修改。find 只返回 const 指针，节点可能被别的版本共享。
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class PersistentAVL {
+public:
+  struct Node {
+    Node(const Key& key, const Value& value) : key(key), value(value) {}
+    Key key;
+    Value value;
+    Node* left = nullptr;
+    Node* right = nullptr;
+    std::atomic<std::uint32_t> refs{1};
+    std::int8_t height = 1;
+  };
+
+  PersistentAVL(const Compare& cmp = Compare()) : compare(cmp) {}
+  PersistentAVL(const PersistentAVL& rhs) : root(retain(rhs.root)), count(rhs.count), compare(rhs.compare) {}
+  PersistentAVL(PersistentAVL&& rhs) noexcept : root(rhs.root), count(rhs.count), compare(rhs.compare) {
+    rhs.root = nullptr, rhs.count = 0;
+  }
+  PersistentAVL& operator=(PersistentAVL rhs) noexcept {
+    std::swap(root, rhs.root);
+    std::swap(count, rhs.count);
+    std::swap(compare, rhs.compare);
+    return *this;
+  }
+  ~PersistentAVL() { release(root); }
+
+  // 当前版本的只读快照，与本对象共享全部节点
+  PersistentAVL snapshot() const { return *this; }
+
+  // 键已存在时覆盖 value 并返回 false
+  bool insert(const Key& key, const Value& value);
+  bool erase(const Key& key);
+
+  const Value* find(const Key& key) const;
+  bool contains(const Key& key) const { return find(key) != nullptr; }
+
+  // 按键的顺序访问每个节点：f(key, value)
+  template <typename F>
+  void for_each(F f) const { walk(root, f); }
+
+  std::size_t size() const { return count; }
+  bool empty() const { return root == nullptr; }
+  int height() const { return height(root); }
+  void clear() {
+    release(root);
+    root = nullptr;
+    count = 0;
+  }
+
+private:
+  static Node* retain(Node* node) {
+    if (node) node->refs.fetch_add(1, std::memory_order_relaxed);
+    return node;
+  }
+  static void release(Node* node) {
+    if (!node || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    release(node->left);
+    release(node->right);
+    delete node;
+  }
+  // 接管调用者对 node 的引用，返回一个只属于调用者、可以原地修改的节点
+  static Node* unique(Node* node);
+
+  static int height(const Node* node) { return node ? node->height : 0; }
+  static int balance(const Node* node) { return height(node->left) - height(node->right); }
+  static void update(Node* node) {
+    int l = height(node->left), r = height(node->right);
+    node->height = static_cast<std::int8_t>(1 + (l > r ? l : r));
+  }
+  // 以下函数的 node 参数都必须是 unique 的，返回值同样是 unique 的
+  static Node* rotate_left(Node* node);
+  static Node* rotate_right(Node* node);
+  static Node* rebalance(Node* node);
+
+  // 接管 node 的引用，返回新子树的引用
+  Node* insert(Node* node, const Key& key, const Value& value, bool& inserted);
+  Node* erase(Node* node, const Key& key);
+  static Node* detach_min(Node* node, Node*& min);
+
+  template <typename F>
+  static void walk(const Node* node, F& f) {
+    if (!node) return;
+    walk(node->left, f);
+    f(node->key, node->value);
+    walk(node->right, f);
+  }
+
+private:
+  Node* root = nullptr;
+  std::size_t count = 0;
+  Compare compare;
+};
+
+template <typename Key, typename Value, typename Compare>
+typename PersistentAVL<Key, Value, Compare>::Node* PersistentAVL<Key, Value, Compare>::unique(Node* node) {
+  // 引用计数为 1 时只有调用者能访问它，别人也无法再增加引用
+  if (node->refs.load(std::memory_order_acquire) == 1) return node;
+
+  Node* copy = new Node(node->key, node->value);
+  copy->left = retain(node->left);
+  copy->right = retain(node->right);
+  copy->height = node->height;
+  release(node);
+
+  return copy;
+}
+
+template <typename Key, typename Value, typename Compare>
+typename PersistentAVL<Key, Value, Compare>::Node* PersistentAVL<Key, Value, Compare>::rotate_left(Node* node) {
+  Node* r = unique(node->right);
+  node->right = r->left;
+  r->left = node;
+  update(node);
+  update(r);
+
+  return r;
+}
+
+template <typename Key, typename Value, typename Compare>
+typename PersistentAVL<Key, Value, Compare>::Node* PersistentAVL<Key, Value, Compare>::rotate_right(Node* node) {
+  Node* l = unique(node->left);
+  node->left = l->right;
+  l->right = node;
+  update(node);
+  update(l);
+
+  return l;
+}
+
+template <typename Key, typename Value, typename Compare>
+typename PersistentAVL<Key, Value, Compare>::Node* PersistentAVL<Key, Value, Compare>::rebalance(Node* node) {
+  update(node);
+  int b = balance(node);
+  if (b > 1) {
+    // LR 型先把左孩子左旋成 LL 型；旋转涉及的孩子在 rotate 中按需复制
+    if (balance(node->left) < 0) node->left = rotate_left(unique(node->left));
+    return rotate_right(node);
+  }
+  if (b < -1) {
+    if (balance(node->right) > 0) node->right = rotate_right(unique(node->right));
+    return rotate_left(node);
+  }
+
+  return node;
+}
+
+template <typename Key, typename Value, typename Compare>
+typename PersistentAVL<Key, Value, Compare>::Node* PersistentAVL<Key, Value, Compare>::insert(Node* node,
+                                                                                             const Key& key,
+                                                                                             const Value& value,
+                                                                                             bool& inserted) {
+  if (node == nullptr) {
+    inserted = true;
+    return new Node(key, value);
+  }
+
+  node = unique(node);
+  if (compare(key, node->key)) node->left = insert(node->left, key, value, inserted);
+  else if (compare(node->key, key)) node->right = insert(node->right, key, value, inserted);
+  else node->value = value;
+
+  return inserted ? rebalance(node) : node;
+}
+
+template <typename Key, typename Value, typename Compare>
+bool PersistentAVL<Key, Value, Compare>::insert(const Key& key, const Value& value) {
+  bool inserted = false;
+  root = insert(root, key, value, inserted);
+  if (inserted) ++count;
+
+  return inserted;
+}
+
+template <typename Key, typename Value, typename Compare>
+typename PersistentAVL<Key, Value, Compare>::Node* PersistentAVL<Key, Value, Compare>::detach_min(Node* node,
+                                                                                                 Node*& min) {
+  node = unique(node);
+  if (node->left == nullptr) {
+    min = node;
+    Node* right = node->right;
+    node->right = nullptr;
+    return right;
+  }
+  node->left = detach_min(node->left, min);
+
+  return rebalance(node);
+}
+
+template <typename Key, typename Value, typename Compare>
+typename PersistentAVL<Key, Value, Compare>::Node* PersistentAVL<Key, Value, Compare>::erase(Node* node,
+                                                                                            const Key& key) {
+  node = unique(node);
+  if (compare(key, node->key)) {
+    node->left = erase(node->left, key);
+  } else if (compare(node->key, key)) {
+    node->right = erase(node->right, key);
+  } else {
+    // 孩子的引用从 node 转交给替代它的节点，node 自己随后释放
+    Node* left = node->left;
+    Node* right = node->right;
+    node->left = node->right = nullptr;
+    release(node);
+    if (!left || !right) return left ? left : right;
+
+    Node* min;
+    right = detach_min(right, min);
+    min->left = left;
+    min->right = right;
+    node = min;
+  }
+
+  return rebalance(node);
+}
+
+template <typename Key, typename Value, typename Compare>
+bool PersistentAVL<Key, Value, Compare>::erase(const Key& key) {
+  // 先确认键存在，避免为不存在的键白白复制一条路径
+  if (!contains(key)) return false;
+  root = erase(root, key);
+  --count;
+
+  return true;
+}
+
+template <typename Key, typename Value, typename Compare>
+const Value* PersistentAVL<Key, Value, Compare>::find(const Key& key) const {
+  const Node* node = root;
+  while (node) {
+    if (compare(key, node->key)) node = node->left;
+    else if (compare(node->key, key)) node = node->right;
+    else return &node->value;
+  }
+
+  return nullptr;
+}
+
+#endif
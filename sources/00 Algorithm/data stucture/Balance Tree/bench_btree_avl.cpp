@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "AVL.h"
+#include "BTreeMap.h"
+
+// AVL 与 BTreeMap 的对比：随机插入、随机查找（一半命中）、顺序扫描、随机删除一半。
+// 两者接口相同，同一份测试代码对两种容器各跑一遍。
+// 用法：bench_btree_avl [键的个数]
+
+template <typename F>
+double seconds(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+  return secs.count();
+}
+
+template <typename Map>
+void run(const char* name, const std::vector<std::int64_t>& keys) {
+  Map map;
+  std::size_t n = keys.size();
+  std::int64_t sum = 0;
+
+  double insert = seconds([&] {
+    for (std::int64_t k : keys) map.insert(2 * k, k);
+  });
+  double find = seconds([&] {
+    for (std::int64_t k : keys) {
+      const std::int64_t* v = map.find(2 * k + (k & 1));
+      if (v) sum += *v;
+    }
+  });
+  double scan = seconds([&] { map.for_each([&](std::int64_t, std::int64_t v) { sum += v; }); });
+  double erase = seconds([&] {
+    for (std::size_t i = 0; i < n; i += 2) map.erase(2 * keys[i]);
+  });
+
+  std::cout << name << "\theight " << map.height() << "\tinsert " << n / insert / 1e6 << "\tfind " << n / find / 1e6
+            << "\tscan " << n / scan / 1e6 << "\terase " << n / 2 / erase / 1e6 << "\t(Mops/s, checksum " << sum
+            << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  std::size_t n = argc > 1 ? std::atoll(argv[1]) : 10000000;
+  std::vector<std::int64_t> keys(n);
+  for (std::size_t i = 0; i < n; ++i) keys[i] = i;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+
+  run<AVL<std::int64_t, std::int64_t>>("AVL", keys);
+  run<BTreeMap<std::int64_t, std::int64_t, std::less<std::int64_t>, 256>>("BTree256", keys);
+  run<BTreeMap<std::int64_t, std::int64_t, std::less<std::int64_t>, 512>>("BTree512", keys);
+  run<BTreeMap<std::int64_t, std::int64_t, std::less<std::int64_t>, 1024>>("BTree1024", keys);
+
+  return 0;
+}
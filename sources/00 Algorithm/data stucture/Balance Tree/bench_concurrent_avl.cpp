@@ -0,0 +1,97 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "AVL.h"
+#include "ConcurrentAVL.h"
+#include "../bench_threads.h"
+
+// 读多写少：一个后台写线程以固定节奏插入/删除（每 16 次修改休眠 50us），其余线程做随机查找。
+// 比较读写锁保护的 AVL 与 ConcurrentAVL 的查找吞吐量随读线程数的变化。
+// 用法：bench_concurrent_avl [最大读线程数] [键的个数] [每个读线程的查找次数]
+
+struct LockedAVL {
+  mutable std::shared_mutex m;
+  AVL<long long, long long> tree;
+
+  void insert(long long k, long long v) {
+    std::unique_lock<std::shared_mutex> lock(m);
+    tree.insert(k, v);
+  }
+  void erase(long long k) {
+    std::unique_lock<std::shared_mutex> lock(m);
+    tree.erase(k);
+  }
+  bool contains(long long k) const {
+    std::shared_lock<std::shared_mutex> lock(m);
+    return tree.contains(k);
+  }
+};
+
+struct Optimistic {
+  ConcurrentAVL<long long, long long> tree;
+
+  void insert(long long k, long long v) { tree.insert(k, v); }
+  void erase(long long k) { tree.erase(k); }
+  bool contains(long long k) const { return tree.contains(k); }
+};
+
+std::atomic<long long> sink{0};  // 防止查找被优化掉
+
+template <typename Map>
+double run(Map& map, int readers, long long keys, long long lookups) {
+  for (long long i = 0; i < keys; i += 2) map.insert(i, i);
+
+  std::atomic<bool> stop{false};
+  std::thread writer([&map, &stop, keys] {
+    std::mt19937_64 rng(42);
+    while (!stop.load(std::memory_order_relaxed)) {
+      for (int i = 0; i < 16; ++i) {
+        long long k = rng() % keys;
+        if (rng() & 1) map.insert(k, k);
+        else map.erase(k);
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < readers; ++t) {
+    workers.emplace_back([&map, t, keys, lookups] {
+      std::mt19937_64 rng(t);
+      long long hits = 0;
+      for (long long i = 0; i < lookups; ++i) hits += map.contains(rng() % keys);
+      sink += hits;
+    });
+  }
+  for (std::thread& w : workers) w.join();
+  std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+  stop = true;
+  writer.join();
+
+  return readers * lookups / secs.count() / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+  int max_threads = argc > 1 ? std::atoi(argv[1]) : (int)std::thread::hardware_concurrency();
+  long long keys = argc > 2 ? std::atoll(argv[2]) : 1000000;
+  long long lookups = argc > 3 ? std::atoll(argv[3]) : 1000000;
+  if (max_threads < 1) max_threads = 1;
+  if (keys < 1) keys = 1;
+
+  std::cout << "readers\trwlock Mops/s\toptimistic Mops/s" << std::endl;
+  for (int t = 1; t <= max_threads; t = next_thread_count(t, max_threads)) {
+    LockedAVL locked;
+    Optimistic optimistic;
+    double a = run(locked, t, keys, lookups);
+    double b = run(optimistic, t, keys, lookups);
+    std::cout << t << "\t" << a << "\t\t" << b << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef BENCH_THREADS_H
+#define BENCH_THREADS_H
+
+// 多线程基准测试的线程数序列：1, 2, 4, ... 按两倍递增，最后一定测一次 max_threads 本身。
+// 用法：for (int t = 1; t <= max_threads; t = next_thread_count(t, max_threads))
+inline int next_thread_count(int t, int max_threads) {
+  if (t >= max_threads) return max_threads + 1;
+  return t * 2 < max_threads ? t * 2 : max_threads;
+}
+
+#endif
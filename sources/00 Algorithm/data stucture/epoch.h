@@ -0,0 +1,149 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// 基于 epoch 的内存回收（EBR）。
+// 读者在访问共享节点前 pin()，得到的 Guard 析构时退出临界区；
+// 写者把已经从数据结构上摘下的节点交给 retire()，而不是直接 delete。
+// 全局 epoch 只有在所有处于临界区的线程都已经观察到当前 epoch 时才能前进，
+// 在 epoch e 退休的节点，等全局 epoch 到达 e + 2 时就不可能再被任何读者引用，可以释放。
+// 每个线程在进程内占用一个固定编号（最多 max_threads 个同时存在的线程），
+// 每个 EpochDomain 为每个编号准备一个独占 cache line 的槽位，pin/unpin 不加锁。
+// 退休的节点也记在本线程的槽位里，攒够 threshold 个时由本线程尝试推进 epoch 并释放，
+// retire/collect 同样不加锁；线程退出时没释放完的节点留给下一个领到该编号的线程，
+// 或者在 EpochDomain 析构时释放。
+class EpochDomain {
+public:
+  static constexpr std::size_t max_threads = 256;
+
+  class Guard {
+  public:
+    explicit Guard(EpochDomain& d) : domain(&d) { domain->enter(); }
+    Guard(Guard&& rhs) noexcept : domain(rhs.domain) { rhs.domain = nullptr; }
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    ~Guard() {
+      if (domain) domain->leave();
+    }
+
+  private:
+    EpochDomain* domain;
+  };
+
+  EpochDomain() = default;
+  EpochDomain(const EpochDomain&) = delete;
+  EpochDomain& operator=(const EpochDomain&) = delete;
+  // 析构时不应再有任何线程处于临界区
+  ~EpochDomain() {
+    for (Slot& s : slots)
+      for (Retired& r : s.retired) r.deleter(r.ptr);
+  }
+
+  Guard pin() { return Guard(*this); }
+
+  void retire(void* p, void (*deleter)(void*)) {
+    Slot& s = slots[thread_index()];
+    s.retired.push_back(Retired{p, deleter, global.load()});
+    if (s.retired.size() >= s.next_collect) collect(s);
+  }
+  template <typename T>
+  void retire(T* p) {
+    retire(p, [](void* q) { delete static_cast<T*>(q); });
+  }
+
+  // 尝试推进 epoch 并释放本线程退休的、已经安全的节点
+  void collect() { collect(slots[thread_index()]); }
+
+private:
+  static constexpr std::uint64_t idle = ~std::uint64_t(0);
+  static constexpr std::size_t threshold = 128;
+
+  struct Retired {
+    void* ptr;
+    void (*deleter)(void*);
+    std::uint64_t epoch;
+  };
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> epoch{idle};
+    unsigned nest = 0;               // 以下各项只由持有该编号的线程访问，nest 支持嵌套 pin
+    std::vector<Retired> retired;
+    std::size_t next_collect = threshold;
+  };
+
+  static std::atomic<bool>* registry() {
+    static std::atomic<bool> used[max_threads];
+    return used;
+  }
+  // 线程第一次使用时领取编号，线程退出时归还
+  static std::size_t thread_index() {
+    struct Registration {
+      std::size_t index = max_threads;
+      Registration() {
+        std::atomic<bool>* used = registry();
+        for (std::size_t i = 0; i < max_threads; ++i) {
+          bool expected = false;
+          if (!used[i].load(std::memory_order_relaxed) && used[i].compare_exchange_strong(expected, true)) {
+            index = i;
+            return;
+          }
+        }
+        std::abort();  // 同时存在的线程超过 max_threads
+      }
+      ~Registration() { registry()[index].store(false, std::memory_order_release); }
+    };
+    thread_local Registration reg;
+    return reg.index;
+  }
+
+  void enter() {
+    Slot& s = slots[thread_index()];
+    if (s.nest++ > 0) return;
+    // 发布自己看到的 epoch 后再确认一次，保证发布的值不落后于全局 epoch
+    std::uint64_t e = global.load();
+    while (true) {
+      s.epoch.store(e);
+      std::uint64_t now = global.load();
+      if (now == e) break;
+      e = now;
+    }
+  }
+  void leave() {
+    Slot& s = slots[thread_index()];
+    if (--s.nest == 0) s.epoch.store(idle, std::memory_order_release);
+  }
+
+  // 所有处于临界区的线程都已观察到当前 epoch 时把它加一，几个线程同时推进时只有一个成功；
+  // 返回推进之后的全局 epoch
+  std::uint64_t try_advance() {
+    std::uint64_t e = global.load();
+    for (const Slot& s : slots) {
+      std::uint64_t se = s.epoch.load();
+      if (se != idle && se != e) return e;
+    }
+    if (global.compare_exchange_strong(e, e + 1)) return e + 1;
+    return e;
+  }
+
+  void collect(Slot& s) {
+    std::uint64_t e = try_advance();
+    std::size_t kept = 0;
+    for (Retired& r : s.retired) {
+      if (r.epoch + 2 <= e) r.deleter(r.ptr);
+      else s.retired[kept++] = r;
+    }
+    s.retired.resize(kept);
+    // epoch 暂时推不动时留下的节点不计入下一次的门槛，否则之后每次 retire 都要扫描一遍
+    s.next_collect = kept + threshold;
+  }
+
+private:
+  Slot slots[max_threads];
+  std::atomic<std::uint64_t> global{0};
+};
+
+#endif
@@ -0,0 +1,326 @@
+#ifndef FLAT_TREE_H
+#define FLAT_TREE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 有序索引的扁平文件格式，可以直接 mmap 后只读查询，不需要反序列化。
+//
+// 文件布局（全部是偏移量，没有指针）：
+//   Header                   64 字节，魔数、版本、元素个数和各段的偏移
+//   keys[count + 1]          按 Eytzinger（BFS）顺序存放的键，下标从 1 开始，keys[0] 不用
+//   values[count + 1]        与 keys 同序的值
+//   strings                  std::string 键/值的字节，槽位里只存 {偏移, 长度}
+// 各段按 64 字节对齐，keys[1..] 的前几层挤在开头几个 cache line 里。
+// 查找是无分支的 Eytzinger 下降（k = 2k + (keys[k] < key)），并提前预取四层之后的 cache line。
+//
+// 键和值可以是可平凡复制的类型（原样写入）或 std::string（查询时以 std::string_view 返回）。
+// 文件按写入时容器的顺序排列，读取时的 Compare 必须与之一致。
+// 写入先写临时文件再 rename，正在映射旧文件的进程不受影响；
+// 映射使用 MAP_SHARED | PROT_READ，多个进程打开同一个文件时共享页缓存，冷启动只剩缺页的开销。
+namespace flat_tree_detail {
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t key_size;
+  std::uint32_t value_size;
+  std::uint32_t flags;  // bit 0：键是字符串，bit 1：值是字符串
+  std::uint64_t count;
+  std::uint64_t keys_offset;
+  std::uint64_t values_offset;
+  std::uint64_t strings_offset;
+  std::uint64_t file_bytes;
+};
+static_assert(sizeof(Header) == 64, "flat tree header is one cache line");
+
+constexpr char magic[8] = {'F', 'L', 'A', 'T', 'T', 'R', 'E', 'E'};
+constexpr std::uint32_t format_version = 1;
+
+struct StringRef {
+  std::uint64_t offset;  // 相对 strings 段
+  std::uint64_t size;
+};
+
+// 存储方式：std::string 存成 StringRef，其他类型原样存储
+template <typename T>
+struct slot {
+  static_assert(std::is_trivially_copyable_v<T>, "flat tree stores trivially copyable types or std::string");
+  using stored = T;
+  using view = T;
+  static constexpr bool is_string = false;
+  static stored store(const T& val, std::string&) { return val; }
+  static view load(const stored& s, const char*) { return s; }
+  static bool valid(const stored&, std::uint64_t) { return true; }
+};
+
+template <>
+struct slot<std::string> {
+  using stored = StringRef;
+  using view = std::string_view;
+  static constexpr bool is_string = true;
+  static stored store(const std::string& val, std::string& strings) {
+    StringRef ref{strings.size(), val.size()};
+    strings += val;
+    return ref;
+  }
+  static view load(const stored& s, const char* strings) { return view(strings + s.offset, s.size); }
+  // 引用的字节必须落在 strings 段（共 strings_bytes 字节）之内
+  static bool valid(const stored& s, std::uint64_t strings_bytes) {
+    return s.offset <= strings_bytes && s.size <= strings_bytes - s.offset;
+  }
+};
+
+inline std::uint64_t align64(std::uint64_t n) { return (n + 63) / 64 * 64; }
+
+[[noreturn]] inline void fail(const char* what) { throw std::system_error(errno, std::generic_category(), what); }
+
+// Eytzinger 顺序（下标从 1 开始）下的中序后继，n 为元素个数，返回 0 表示遍历结束
+inline std::size_t next_inorder(std::size_t k, std::size_t n) {
+  if (2 * k + 1 <= n) {
+    k = 2 * k + 1;
+    while (2 * k <= n) k = 2 * k;
+    return k;
+  }
+  while (k & 1) k >>= 1;
+  return k >> 1;
+}
+inline std::size_t first_inorder(std::size_t n) {
+  std::size_t k = 1;
+  while (2 * k <= n) k = 2 * k;
+  return n ? k : 0;
+}
+
+template <typename Source, typename Key, typename Value, typename = void>
+struct has_for_each : std::false_type {};
+template <typename Source, typename Key, typename Value>
+struct has_for_each<Source, Key, Value,
+                    std::void_t<decltype(std::declval<const Source&>().for_each(
+                        std::declval<void (*)(const Key&, const Value&)>()))>> : std::true_type {};
+
+}  // namespace flat_tree_detail
+
+// 把按键递增的序列写成扁平文件。source 可以是任何提供 for_each(f(key, value)) 的有序容器
+// （AVL、BTreeMap、PersistentAVL ……），也可以是一个 visit(f) 函数，按顺序对每个元素调用 f(key, value)。
+// 序列会被遍历两次：第一次计数，第二次写入。
+template <typename Key, typename Value, typename Source>
+void write_flat_tree(const std::string& path, const Source& source) {
+  using namespace flat_tree_detail;
+  using KeySlot = slot<Key>;
+  using ValueSlot = slot<Value>;
+
+  auto visit = [&source](auto f) {
+    if constexpr (has_for_each<Source, Key, Value>::value) source.for_each(f);
+    else source(f);
+  };
+  std::size_t n = 0;
+  visit([&n](const Key&, const Value&) { ++n; });
+
+  std::vector<typename KeySlot::stored> keys(n + 1);
+  std::vector<typename ValueSlot::stored> values(n + 1);
+  std::string strings;
+  // 中序遍历 Eytzinger 隐式树的位置，恰好与有序输入一一对应
+  std::size_t k = first_inorder(n);
+  visit([&](const Key& key, const Value& value) {
+    keys[k] = KeySlot::store(key, strings);
+    values[k] = ValueSlot::store(value, strings);
+    k = next_inorder(k, n);
+  });
+
+  Header h = {};
+  std::memcpy(h.magic, magic, sizeof(magic));
+  h.version = format_version;
+  h.key_size = sizeof(typename KeySlot::stored);
+  h.value_size = sizeof(typename ValueSlot::stored);
+  h.flags = (KeySlot::is_string ? 1u : 0u) | (ValueSlot::is_string ? 2u : 0u);
+  h.count = n;
+  h.keys_offset = align64(sizeof(Header));
+  h.values_offset = align64(h.keys_offset + keys.size() * sizeof(keys[0]));
+  h.strings_offset = align64(h.values_offset + values.size() * sizeof(values[0]));
+  h.file_bytes = h.strings_offset + strings.size();
+
+  std::string tmp = path + ".XXXXXX";
+  int fd = mkstemp(&tmp[0]);
+  if (fd < 0) fail("mkstemp");
+  auto abort_write = [&](const char* what) {
+    int err = errno;
+    close(fd);
+    unlink(tmp.c_str());
+    errno = err;
+    fail(what);
+  };
+  auto put = [&](std::uint64_t offset, const void* data, std::size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+      ssize_t w = pwrite(fd, p, bytes, static_cast<off_t>(offset));
+      if (w < 0) {
+        if (errno == EINTR) continue;
+        abort_write("pwrite");
+      }
+      p += w, offset += w, bytes -= w;
+    }
+  };
+  if (ftruncate(fd, static_cast<off_t>(h.file_bytes)) < 0) abort_write("ftruncate");
+  put(0, &h, sizeof(h));
+  put(h.keys_offset, keys.data(), keys.size() * sizeof(keys[0]));
+  put(h.values_offset, values.data(), values.size() * sizeof(values[0]));
+  put(h.strings_offset, strings.data(), strings.size());
+  // mkstemp 创建的文件权限是 0600，改成普通数据文件的权限，其他用户的进程也能打开
+  if (fchmod(fd, 0644) < 0) abort_write("fchmod");
+  if (close(fd) < 0) {
+    unlink(tmp.c_str());
+    fail("close");
+  }
+  if (rename(tmp.c_str(), path.c_str()) < 0) {
+    int err = errno;
+    unlink(tmp.c_str());
+    errno = err;
+    fail("rename");
+  }
+}
+
+// 只读打开一个扁平文件。Key / Value 必须与写入时一致；字符串以 std::string_view 返回，
+// 指向映射区，FlatTree 析构后失效。Compare 作用在 key_view 上（默认的 std::less<> 对
+// 数值和 string_view 都适用），给出的顺序必须与写入时容器的顺序相同。
+template <typename Key, typename Value, typename Compare = std::less<>>
+class FlatTree {
+  using KeySlot = flat_tree_detail::slot<Key>;
+  using ValueSlot = flat_tree_detail::slot<Value>;
+  using KeyStored = typename KeySlot::stored;
+  using ValueStored = typename ValueSlot::stored;
+
+public:
+  using key_view = typename KeySlot::view;
+  using value_view = typename ValueSlot::view;
+
+  explicit FlatTree(const std::string& path, const Compare& cmp = Compare());
+  FlatTree(const FlatTree&) = delete;
+  FlatTree& operator=(const FlatTree&) = delete;
+  FlatTree(FlatTree&& rhs) noexcept
+      : base(rhs.base), bytes(rhs.bytes), n(rhs.n), keys(rhs.keys), values(rhs.values), strings(rhs.strings),
+        compare(rhs.compare) {
+    rhs.base = nullptr, rhs.bytes = 0, rhs.n = 0;
+  }
+  ~FlatTree() {
+    if (base) munmap(base, bytes);
+  }
+
+  std::optional<value_view> find(const key_view& key) const {
+    std::size_t k = lower(key);
+    if (k == 0 || compare(key, key_at(k))) return std::nullopt;
+    return ValueSlot::load(values[k], strings);
+  }
+  bool contains(const key_view& key) const { return find(key).has_value(); }
+
+  // 按键的顺序访问每个元素：f(key, value)
+  template <typename F>
+  void for_each(F f) const {
+    for (std::size_t k = flat_tree_detail::first_inorder(n); k != 0; k = flat_tree_detail::next_inorder(k, n))
+      f(key_at(k), ValueSlot::load(values[k], strings));
+  }
+
+  std::size_t size() const { return n; }
+  bool empty() const { return n == 0; }
+
+private:
+  key_view key_at(std::size_t k) const { return KeySlot::load(keys[k], strings); }
+  // 第一个 >= key 的元素在 Eytzinger 数组中的下标，不存在时返回 0
+  std::size_t lower(const key_view& key) const {
+    constexpr std::size_t per_line = sizeof(KeyStored) < 64 ? 64 / sizeof(KeyStored) : 1;
+    std::size_t k = 1;
+    while (k <= n) {
+      // 子孙 k * per_line 起的一整行在几层之后会被访问到
+      __builtin_prefetch(keys + std::min(k * per_line, n));
+      k = 2 * k + compare(key_at(k), key);
+    }
+    // 去掉最后一串向右走的步骤，回到最后一次向左走的那个节点
+    return k >> __builtin_ffsll(~static_cast<long long>(k));
+  }
+
+private:
+  void* base = nullptr;
+  std::size_t bytes = 0;
+  std::size_t n = 0;
+  const KeyStored* keys = nullptr;
+  const ValueStored* values = nullptr;
+  const char* strings = nullptr;
+  Compare compare;
+};
+
+template <typename Key, typename Value, typename Compare>
+FlatTree<Key, Value, Compare>::FlatTree(const std::string& path, const Compare& cmp) : compare(cmp) {
+  using namespace flat_tree_detail;
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) fail("open");
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    int err = errno;
+    close(fd);
+    errno = err;
+    fail("fstat");
+  }
+  bytes = static_cast<std::size_t>(st.st_size);
+  if (bytes < sizeof(Header)) {
+    close(fd);
+    throw std::runtime_error("flat tree: file too small");
+  }
+  base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    base = nullptr;
+    fail("mmap");
+  }
+
+  const Header* h = static_cast<const Header*>(base);
+  const char* error = nullptr;
+  if (std::memcmp(h->magic, magic, sizeof(magic)) != 0 || h->version != format_version) error = "bad magic or version";
+  else if (h->key_size != sizeof(KeyStored) || h->value_size != sizeof(ValueStored) ||
+           h->flags != ((KeySlot::is_string ? 1u : 0u) | (ValueSlot::is_string ? 2u : 0u)))
+    error = "key/value type mismatch";
+  else if (h->file_bytes != bytes || h->count >= bytes / sizeof(KeyStored) || h->count >= bytes / sizeof(ValueStored) ||
+           h->keys_offset > bytes || (h->count + 1) * sizeof(KeyStored) > bytes - h->keys_offset ||
+           h->values_offset > bytes || (h->count + 1) * sizeof(ValueStored) > bytes - h->values_offset ||
+           h->strings_offset > bytes)
+    error = "truncated file";
+  else if (KeySlot::is_string || ValueSlot::is_string) {
+    // 每个字符串引用只在打开时检查一次（顺序扫描 O(n)），查询时不再做边界检查
+    const char* p = static_cast<const char*>(base);
+    const KeyStored* ks = reinterpret_cast<const KeyStored*>(p + h->keys_offset);
+    const ValueStored* vs = reinterpret_cast<const ValueStored*>(p + h->values_offset);
+    std::uint64_t limit = bytes - h->strings_offset;
+    for (std::size_t k = 1; k <= h->count && !error; ++k)
+      if (!KeySlot::valid(ks[k], limit) || !ValueSlot::valid(vs[k], limit)) error = "string out of range";
+  }
+  if (error) {
+    munmap(base, bytes);
+    base = nullptr;
+    throw std::runtime_error(std::string("flat tree: ") + error);
+  }
+
+  n = h->count;
+  const char* p = static_cast<const char*>(base);
+  keys = reinterpret_cast<const KeyStored*>(p + h->keys_offset);
+  values = reinterpret_cast<const ValueStored*>(p + h->values_offset);
+  strings = p + h->strings_offset;
+  // 上层节点会被每次查找访问到，让内核整段预读
+  madvise(base, bytes, MADV_WILLNEED);
+}
+
+#endif
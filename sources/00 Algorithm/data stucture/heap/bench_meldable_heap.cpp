@@ -0,0 +1,174 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include "heap.h"
+#include "left_tree.h"
+#include "pairing_heap.h"
+#include "skew_heap.h"
+
+// 可合并堆对比：LeftTree / SkewHeap / PairingHeap，以不可合并的 Heap 为基线。
+// 四种负载（n 次操作，小根堆，键为 uint64_t）：
+//   push-heavy    90% push / 10% pop
+//   pop-heavy     先压入 n 个，再 90% pop / 10% push
+//   merge-heavy   16 个队列，随机 push，每 64 次操作模拟一次窃取：把一个队列整体并入另一个
+//   decrease-key  保持 n/4 个元素，70% decrease-key / 30% pop+push；
+//                 PairingHeap 用原生 decrease_key，其余堆用“重复插入 + 出堆时丢弃过期项”
+// 用法：bench_meldable_heap [n]
+
+using Key = std::uint64_t;
+using Item = std::pair<Key, std::uint32_t>;
+using Clock = std::chrono::steady_clock;
+
+// 把 b 整体并入 a，b 变空；a 与 b 是同一个队列时什么也不做
+template <typename Q>
+void meld(Q& a, Q& b) {
+  if (&a != &b) a.merge(b);
+}
+template <typename T, typename C, std::size_t A>
+void meld(Heap<T, C, A>& a, Heap<T, C, A>& b) {
+  if (&a == &b) return;
+  Heap<T, C, A> from(std::move(b));
+  b.clear();
+  a.push_range(from.begin(), from.end());
+}
+
+template <typename Q>
+double push_heavy(std::size_t n) {
+  std::mt19937_64 rng(1);
+  Q q;
+  Key sum = 0;
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < n; ++i) {
+    if (i % 10 == 9 && !q.empty()) sum += q.pop();
+    else q.push(rng());
+  }
+  std::chrono::duration<double, std::nano> ns = Clock::now() - start;
+  volatile Key sink = sum;
+  (void)sink;
+  return ns.count() / n;
+}
+
+template <typename Q>
+double pop_heavy(std::size_t n) {
+  std::mt19937_64 rng(2);
+  Q q;
+  for (std::size_t i = 0; i < n; ++i) q.push(rng());
+  Key sum = 0;
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < n; ++i) {
+    if (i % 10 == 9 || q.empty()) q.push(rng());
+    else sum += q.pop();
+  }
+  std::chrono::duration<double, std::nano> ns = Clock::now() - start;
+  volatile Key sink = sum;
+  (void)sink;
+  return ns.count() / n;
+}
+
+template <typename Q>
+double merge_heavy(std::size_t n) {
+  std::mt19937_64 rng(3);
+  std::vector<Q> qs(16);
+  Key sum = 0;
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < n; ++i) {
+    std::size_t k = rng() % qs.size();
+    Q& q = qs[k];
+    if (i % 64 == 63) {
+      // 被窃取的队列总是另一个
+      meld(q, qs[(k + 1 + rng() % (qs.size() - 1)) % qs.size()]);
+    } else if (i % 4 == 3 && !q.empty()) {
+      sum += q.pop();
+    } else {
+      q.push(rng());
+    }
+  }
+  std::chrono::duration<double, std::nano> ns = Clock::now() - start;
+  volatile Key sink = sum;
+  (void)sink;
+  return ns.count() / n;
+}
+
+// 惰性 decrease-key：每次更新都插入新的 (key, id)，出堆时与 current[id] 不符的就是过期项
+template <typename Q>
+double decrease_key_lazy(std::size_t n) {
+  std::mt19937_64 rng(4);
+  std::size_t live = n / 4 ? n / 4 : 1;
+  std::vector<Key> current(live);
+  Q q;
+  for (std::uint32_t id = 0; id < live; ++id) q.push(Item(current[id] = rng() >> 1, id));
+
+  Key sum = 0;
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < n; ++i) {
+    if (rng() % 10 < 7) {
+      std::uint32_t id = rng() % live;
+      current[id] -= current[id] / 4;
+      q.push(Item(current[id], id));
+    } else {
+      Item it;
+      do it = q.pop();
+      while (it.first != current[it.second]);
+      sum += it.first;
+      q.push(Item(current[it.second] = it.first + (rng() >> 8), it.second));
+    }
+  }
+  std::chrono::duration<double, std::nano> ns = Clock::now() - start;
+  volatile Key sink = sum;
+  (void)sink;
+  return ns.count() / n;
+}
+
+double decrease_key_pairing(std::size_t n) {
+  using Q = PairingHeap<Item, std::greater<Item>>;
+  std::mt19937_64 rng(4);
+  std::size_t live = n / 4 ? n / 4 : 1;
+  std::vector<Key> current(live);
+  std::vector<Q::handle> where(live);
+  Q q;
+  for (std::uint32_t id = 0; id < live; ++id) where[id] = q.push(Item(current[id] = rng() >> 1, id));
+
+  Key sum = 0;
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < n; ++i) {
+    if (rng() % 10 < 7) {
+      std::uint32_t id = rng() % live;
+      current[id] -= current[id] / 4;
+      q.decrease_key(where[id], Item(current[id], id));
+    } else {
+      Item it = q.pop();
+      sum += it.first;
+      where[it.second] = q.push(Item(current[it.second] = it.first + (rng() >> 8), it.second));
+    }
+  }
+  std::chrono::duration<double, std::nano> ns = Clock::now() - start;
+  volatile Key sink = sum;
+  (void)sink;
+  return ns.count() / n;
+}
+
+template <template <typename, typename> class Q>
+void row(const char* name, std::size_t n, double dk) {
+  std::cout << name << "\t" << push_heavy<Q<Key, std::greater<Key>>>(n) << "\t"
+            << pop_heavy<Q<Key, std::greater<Key>>>(n) << "\t" << merge_heavy<Q<Key, std::greater<Key>>>(n)
+            << "\t" << dk << std::endl;
+}
+
+template <typename T, typename C>
+using Heap4 = Heap<T, C, 4>;
+
+int main(int argc, char* argv[]) {
+  std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+  std::cout << "ns/op\t\tpush\tpop\tmerge\tdecrease-key" << std::endl;
+  row<Heap4>("Heap<4>\t", n, decrease_key_lazy<Heap4<Item, std::greater<Item>>>(n));
+  row<LeftTree>("LeftTree", n, decrease_key_lazy<LeftTree<Item, std::greater<Item>>>(n));
+  row<SkewHeap>("SkewHeap", n, decrease_key_lazy<SkewHeap<Item, std::greater<Item>>>(n));
+  row<PairingHeap>("PairingHeap", n, decrease_key_pairing(n));
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "heap.h"
+#include "multi_queue.h"
+#include "../bench_threads.h"
+
+// 多线程吞吐量：每个线程交替 push/pop，比较单锁 Heap 与 MultiQueue。
+// 用法：bench_multi_queue [最大线程数] [每线程操作数]
+
+struct LockedHeap {
+  std::mutex m;
+  Heap<long long, std::greater<long long>, 4> heap;
+
+  void push(long long v) {
+    std::lock_guard<std::mutex> lock(m);
+    heap.push(v);
+  }
+  bool pop(long long& v) {
+    std::lock_guard<std::mutex> lock(m);
+    if (heap.empty()) return false;
+    v = heap.pop();
+    return true;
+  }
+};
+
+struct Relaxed {
+  MultiQueue<long long, std::greater<long long>, 4> queue;
+  explicit Relaxed(std::size_t threads) : queue(threads, 4) {}
+
+  void push(long long v) { queue.push(v); }
+  bool pop(long long& v) {
+    std::optional<long long> val = queue.pop();
+    if (!val) return false;
+    v = *val;
+    return true;
+  }
+};
+
+template <typename Queue>
+double run(Queue& q, int threads, long long ops) {
+  for (long long i = 0; i < 1024 * threads; ++i) q.push(i);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&q, t, ops] {
+      std::mt19937_64 rng(t);
+      long long v;
+      for (long long i = 0; i < ops; ++i) {
+        if (i & 1) q.pop(v);
+        else q.push(rng() >> 20);
+      }
+    });
+  }
+  for (std::thread& w : workers) w.join();
+  std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+  return threads * ops / secs.count() / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+  int max_threads = argc > 1 ? std::atoi(argv[1]) : (int)std::thread::hardware_concurrency();
+  long long ops = argc > 2 ? std::atoll(argv[2]) : 1000000;
+  if (max_threads < 1) max_threads = 1;
+
+  std::cout << "threads\tmutex Mops/s\tmultiqueue Mops/s" << std::endl;
+  for (int t = 1; t <= max_threads; t = next_thread_count(t, max_threads)) {
+    LockedHeap locked;
+    Relaxed relaxed(t);
+    double a = run(locked, t, ops);
+    double b = run(relaxed, t, ops);
+    std::cout << t << "\t" << a << "\t\t" << b << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include "heap.h"
+#include "radix_heap.h"
+
+// 单调工作负载：保持队列中约 n 个元素，每次 pop 出键 k 后再 push 一个 k + [0, C) 的键，
+// 模拟定时器轮转和整数边权的 Dijkstra。C 越小，radix heap 的桶越浅，优势越大。
+// 用法：bench_radix_heap [n] [ops]
+
+template <typename Push, typename Pop>
+double run(std::size_t n, std::size_t ops, std::uint32_t range, Push push, Pop pop) {
+  std::mt19937 rng(42);
+  for (std::size_t i = 0; i < n; ++i) push(rng() % range, i);
+
+  auto start = std::chrono::steady_clock::now();
+  std::uint64_t sum = 0;
+  for (std::size_t i = 0; i < ops; ++i) {
+    std::pair<std::uint32_t, std::uint32_t> e = pop();
+    sum += e.second;
+    push(e.first + rng() % range, e.second);
+  }
+  std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+
+  volatile std::uint64_t sink = sum;
+  (void)sink;
+  return ns.count() / ops;
+}
+
+int main(int argc, char* argv[]) {
+  std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  std::size_t ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5000000;
+
+  using Entry = std::pair<std::uint32_t, std::uint32_t>;
+  std::cout << "C\tHeap<4>\tRadixHeap (ns per pop+push)" << std::endl;
+  for (std::uint32_t range : {16u, 1024u, 1u << 20}) {
+    Heap<Entry, std::greater<Entry>, 4> heap;
+    double a = run(n, ops, range,
+                   [&](std::uint32_t k, std::uint32_t v) { heap.push(Entry(k, v)); },
+                   [&] { return heap.pop(); });
+
+    RadixHeap<std::uint32_t, std::uint32_t> radix;
+    double b = run(n, ops, range,
+                   [&](std::uint32_t k, std::uint32_t v) { radix.push(k, v); },
+                   [&] { return radix.pop(); });
+    std::cout << range << "\t" << a << "\t" << b << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,47 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "heap.h"
+#include "simd_heap.h"
+
+// 小根堆：先压入 n 个随机 int，再全部弹出，统计平均每次 pop 的耗时。
+// 用法：bench_simd_heap [n ...]，默认 10^6 与 10^7；10^8 需要约 1.2 GB 内存。
+
+template <typename Queue>
+double pop_ns(const std::vector<std::int32_t>& keys) {
+  Queue q;
+  q.reserve(keys.size());
+  for (std::int32_t k : keys) q.push(k);
+
+  auto start = std::chrono::steady_clock::now();
+  std::int64_t sum = 0;
+  while (!q.empty()) sum += q.pop();
+  std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+
+  volatile std::int64_t sink = sum;
+  (void)sink;
+  return ns.count() / keys.size();
+}
+
+int main(int argc, char* argv[]) {
+  std::vector<std::size_t> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+  if (sizes.empty()) sizes = {1000000, 10000000};
+
+  std::cout << "n\tbinary Heap\t8-ary Heap\tSimdHeap (ns/pop)" << std::endl;
+  for (std::size_t n : sizes) {
+    std::mt19937 rng(n);
+    std::vector<std::int32_t> keys(n);
+    for (std::int32_t& k : keys) k = static_cast<std::int32_t>(rng());
+
+    double a = pop_ns<Heap<std::int32_t, std::greater<std::int32_t>, 2>>(keys);
+    double b = pop_ns<Heap<std::int32_t, std::greater<std::int32_t>, 8>>(keys);
+    double c = pop_ns<SimdHeap<std::int32_t, std::greater<std::int32_t>>>(keys);
+    std::cout << n << "\t" << a << "\t\t" << b << "\t\t" << c << std::endl;
+  }
+
+  return 0;
+}
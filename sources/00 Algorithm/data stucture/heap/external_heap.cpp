@@ -0,0 +1,33 @@
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "external_heap.h"
+
+struct Job {
+  long long deadline;
+  long long id;
+  bool operator>(const Job& rhs) const { return deadline > rhs.deadline; }
+};
+
+// 用法：external_heap [jobs] [memory_items]
+int main(int argc, char* argv[]) {
+  long long jobs = argc > 1 ? std::atoll(argv[1]) : 1000000;
+  std::size_t memory = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+  ExternalHeap<Job, std::greater<Job>> q(memory);
+  std::mt19937_64 rng(1);
+  for (long long i = 0; i < jobs; ++i) q.push(Job{static_cast<long long>(rng() >> 24), i});
+  std::cout << "runs on disk: " << q.run_count() << ", size: " << q.size() << std::endl;
+
+  long long prev = -1, popped = 0;
+  bool sorted = true;
+  while (!q.empty()) {
+    Job j = q.pop();
+    sorted = sorted && j.deadline >= prev;
+    prev = j.deadline;
+    ++popped;
+  }
+  std::cout << "popped " << popped << (sorted ? " in order" : " OUT OF ORDER") << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+#ifndef EXTERNAL_HEAP_H
+#define EXTERNAL_HEAP_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "heap.h"
+
+// 外存优先队列（POSIX）：
+//   - 内存中只有一个最多 memory_items 个元素的插入堆；
+//   - 插入堆满时把全部元素排好序，以 block_bytes 为单位顺序写成磁盘上的一个有序 run；
+//   - run 文件通过 mmap 只读映射，MADV_SEQUENTIAL 让内核预读，
+//     已经消费过的整块用 MADV_DONTNEED 归还，常驻页保持在每个 run 一两块；
+//   - pop 在插入堆堆顶与 run 头部的多路归并堆之间取更优者。
+// 所有 I/O 都是顺序的块读写。run 文件创建后立即 unlink，进程退出时自动回收。
+// T 必须是可平凡复制的，因为它会被原样写入文件。
+template <typename T, typename Compare = std::less<T>>
+class ExternalHeap {
+  static_assert(std::is_trivially_copyable_v<T>, "ExternalHeap stores T as raw bytes");
+
+public:
+  ExternalHeap(std::size_t memory_items, std::string dir = "/tmp", std::size_t block_bytes = 1 << 20,
+               const Compare& cmp = Compare())
+      : memory_items(memory_items ? memory_items : 1), block_bytes(block_bytes), dir(std::move(dir)),
+        compare(cmp), insertion(cmp), merge(HeadCompare{cmp}) {
+    insertion.reserve(this->memory_items);
+  }
+  ExternalHeap(const ExternalHeap&) = delete;
+  ExternalHeap& operator=(const ExternalHeap&) = delete;
+  ~ExternalHeap() {
+    for (Run& r : runs) unmap(r);
+  }
+
+  void push(const T& val) {
+    if (insertion.size() == memory_items) spill();
+    insertion.push(val);
+  }
+  T pop();
+  const T& top() const { return from_runs() ? merge.top().val : insertion.top(); }
+
+  bool empty() const { return insertion.empty() && merge.empty(); }
+  std::size_t size() const { return insertion.size() + on_disk; }
+  // 还没读完的 run 数，每个都恰好有一个头部元素在 merge 里
+  std::size_t run_count() const { return merge.size(); }
+
+private:
+  struct Run {
+    const T* base = nullptr;
+    std::size_t n = 0;
+    std::size_t pos = 0;       // 下一个要读的元素
+    std::size_t released = 0;  // [0, released) 已经 MADV_DONTNEED
+  };
+  struct Head {
+    T val;
+    std::size_t run;
+  };
+  struct HeadCompare {
+    Compare compare;
+    bool operator()(const Head& a, const Head& b) const { return compare(a.val, b.val); }
+  };
+
+  bool from_runs() const {
+    return !merge.empty() && (insertion.empty() || !compare(merge.top().val, insertion.top()));
+  }
+  void spill();
+  void release(Run& r);
+  void unmap(Run& r) {
+    if (r.base) munmap(const_cast<T*>(r.base), r.n * sizeof(T));
+    r.base = nullptr;
+  }
+  static void fail(const char* what) { throw std::system_error(errno, std::generic_category(), what); }
+
+private:
+  std::size_t memory_items;
+  std::size_t block_bytes;
+  std::string dir;
+  Compare compare;
+  Heap<T, Compare, 4> insertion;
+  Heap<Head, HeadCompare, 4> merge;
+  std::vector<Run> runs;
+  std::size_t on_disk = 0;  // 尚未被 pop 的磁盘元素个数
+};
+
+template <typename T, typename Compare>
+void ExternalHeap<T, Compare>::spill() {
+  std::string path = dir + "/external_heap.XXXXXX";
+  int fd = mkstemp(&path[0]);
+  if (fd < 0) fail("mkstemp");
+  unlink(path.c_str());
+
+  // 插入堆就地排序后直接写盘，不额外占用内存；有序数组仍是合法的堆，
+  // 写盘或映射失败（例如 ENOSPC）时插入堆不用恢复，也不会丢元素，mmap 成功之后才清空。
+  // run 内部从好到差有序，与 pop 的顺序相同
+  insertion.sort();
+  std::size_t n = insertion.size();
+  std::size_t per_block = block_bytes / sizeof(T) ? block_bytes / sizeof(T) : 1;
+  for (std::size_t i = 0; i < n; i += per_block) {
+    const char* p = reinterpret_cast<const char*>(insertion.begin() + i);
+    std::size_t left = (n - i < per_block ? n - i : per_block) * sizeof(T);
+    while (left > 0) {
+      ssize_t w = write(fd, p, left);
+      if (w < 0) {
+        if (errno == EINTR) continue;
+        int err = errno;
+        close(fd);
+        errno = err;
+        fail("write");
+      }
+      p += w, left -= w;
+    }
+  }
+
+  void* base = mmap(nullptr, n * sizeof(T), PROT_READ, MAP_PRIVATE, fd, 0);
+  int err = errno;
+  close(fd);
+  errno = err;
+  if (base == MAP_FAILED) fail("mmap");
+  madvise(base, n * sizeof(T), MADV_SEQUENTIAL);
+  insertion.clear();
+
+  // 复用已经读完的 run 的位置，runs 的长度不超过同时存活的 run 数
+  std::size_t slot = 0;
+  while (slot < runs.size() && runs[slot].base) ++slot;
+  if (slot == runs.size()) runs.emplace_back();
+  Run& r = runs[slot];
+  r = Run();
+  r.base = static_cast<const T*>(base);
+  r.n = n;
+  r.pos = 1;
+  on_disk += n;
+  merge.push(Head{r.base[0], slot});
+}
+
+template <typename T, typename Compare>
+void ExternalHeap<T, Compare>::release(Run& r) {
+  // 归还已经完整读过的块，只保留当前块常驻
+  std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  std::size_t chunk = block_bytes / page * page;
+  if (!chunk) return;
+  std::size_t done = r.pos * sizeof(T) / chunk * chunk;
+  if (done > r.released) {
+    madvise(const_cast<char*>(reinterpret_cast<const char*>(r.base)) + r.released, done - r.released,
+            MADV_DONTNEED);
+    r.released = done;
+  }
+}
+
+template <typename T, typename Compare>
+T ExternalHeap<T, Compare>::pop() {
+  if (!from_runs()) return insertion.pop();
+
+  std::size_t run = merge.top().run;
+  Run& r = runs[run];
+  --on_disk;
+  if (r.pos == r.n) {
+    unmap(r);
+    return merge.pop().val;
+  }
+  release(r);
+  return merge.replace_top(Head{r.base[r.pos++], run}).val;
+}
+
+#endif
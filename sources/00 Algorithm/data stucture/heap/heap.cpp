@@ -1,71 +1,47 @@
 #include <iostream>
+#include <iterator>
+#include <string>
 #include <vector>
+#include "heap.h"
 
-class Heap {
-public:
-  Heap(std::vector<int>& in) : data(in) {
-    make_heap();
-  }
-
-  void push(int val);
-  int pop();
-  bool empty() { return data.empty(); }
-
-private:
-  void up(int index);
-  void down(int index);
-  void make_heap();
-
-private:
-  std::vector<int> data;
+struct Task {
+  long long when;
+  long long id;
+  bool operator>(const Task& rhs) const { return when > rhs.when; }
 };
 
-void Heap::up(int index) {
-  while (index > 1 && data[index - 1] > data[index / 2 - 1]) {
-    std::swap(data[index - 1], data[index / 2 - 1]);
-    index /= 2;
-  }
-}
-
-void Heap::down(int index) {
-  while (index * 2 <= data.size()) {
-    int tmp = index * 2;
-    if (tmp + 1 <= data.size() && data[tmp - 1] < data[tmp]) ++tmp;
-    if (data[tmp - 1] < data[index - 1]) break;
-    std::swap(data[tmp - 1], data[index - 1]);
-    index = tmp;
-  }
-}
-
-void Heap::push(int val) {
-  data.push_back(val);
-  up(data.size());
-}
-
-int Heap::pop() {
-  std::swap(*data.begin(), *(data.end() - 1));
-  int val = data.back();
-  data.pop_back();
-  down(1);
-
-  return val;
-}
-
-void Heap::make_heap() {
-  // for (int i = 1; i <= data.size(); ++i) 
-  //   up(i);
-  for (int i = data.size(); i > 0; --i)
-    down(i);
-}
-
-
 int main() {
   std::vector<int> data{1,2,3,4,5,6,7,8,9,10};
-  Heap h(data);
+  Heap<int> h(data);
   while (!h.empty()) {
     int val = h.pop();
     std::cout << val << std::endl;
   }
 
+  // 16 字节的任务，4 叉小根堆：每组兄弟恰好占一条 cache line。
+  Heap<Task, std::greater<Task>, 4> tasks;
+  for (long long i = 0; i < 10; ++i) tasks.emplace(Task{(i * 7) % 10, i});
+  while (!tasks.empty()) {
+    Task t = tasks.pop();
+    std::cout << t.when << ":" << t.id << " ";
+  }
+  std::cout << std::endl;
+
+  Heap<std::string, std::less<std::string>, 8> words;
+  for (std::string w : {"Piglet", "Eeyore", "Roo", "Tigger", "Chris", "Pooh", "Kanga"})
+    words.push(std::move(w));
+  while (!words.empty()) std::cout << words.pop() << " ";
+  std::cout << std::endl;
+
+  // 批量补充后一次取出前 5 个
+  Heap<int, std::less<int>, 4> refill;
+  std::vector<int> batch;
+  for (int i = 0; i < 100; ++i) batch.push_back(i * 37 % 100);
+  refill.push_range(batch.begin(), batch.end());
+  std::vector<int> front;
+  refill.pop_n(5, std::back_inserter(front));
+  for (int v : front) std::cout << v << " ";
+  std::cout << "(" << refill.size() << " left)" << std::endl;
+
   return 0;
-}
\ No newline at end of file
+}
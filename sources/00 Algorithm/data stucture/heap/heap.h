@@ -0,0 +1,275 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// d 叉堆，Arity 在编译期确定（2/4/8）。
+// 下标从 0 开始：i 的孩子为 Arity*i+1 .. Arity*i+Arity，父亲为 (i-1)/Arity。
+// 存储区按 cache line 对齐，并在数组头部空出 Arity-1 个槽位，
+// 使每一组兄弟节点都从 Arity 的整数倍位置开始；当 sizeof(T)*Arity 能整除
+// cache line 大小（即是不超过 64 的 2 的幂）时，一组兄弟不会跨行，
+// down() 每层只会碰到一条 cache line。
+// Compare 与 std::priority_queue 相同：默认 std::less，堆顶为最大值。
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 2>
+class Heap {
+  static_assert(Arity == 2 || Arity == 4 || Arity == 8, "Arity must be 2, 4 or 8");
+
+public:
+  static constexpr std::size_t cache_line = 64;
+
+  Heap(const Compare& cmp = Compare()) : compare(cmp) {}
+  Heap(const std::vector<T>& in, const Compare& cmp = Compare()) : compare(cmp) {
+    reserve(in.size());
+    for (const T& val : in) new (data + count++) T(val);
+    make_heap();
+  }
+  Heap(const Heap& rhs) : compare(rhs.compare) {
+    reserve(rhs.count);
+    for (; count < rhs.count; ++count) new (data + count) T(rhs.data[count]);
+  }
+  Heap(Heap&& rhs) noexcept : compare(std::move(rhs.compare)) { steal(rhs); }
+  ~Heap() { release(); }
+
+  Heap& operator=(Heap rhs) noexcept {
+    release();
+    compare = std::move(rhs.compare);
+    steal(rhs);
+    return *this;
+  }
+
+  void push(const T& val) { emplace(val); }
+  void push(T&& val) { emplace(std::move(val)); }
+  template <typename... Args>
+  void emplace(Args&&... args);
+  T pop();
+  // 用 val 替换堆顶并下沉，等价于 pop() 后 push(val)，但只做一次 down。
+  T replace_top(T val);
+
+  // 批量插入：先全部追加到末尾，再按批次大小选择逐个上浮或整体 Floyd 重建。
+  template <typename InputIt>
+  void push_range(InputIt first, InputIt last);
+  // 依次弹出至多 k 个元素写入 out，返回实际弹出的个数。
+  template <typename OutputIt>
+  std::size_t pop_n(std::size_t k, OutputIt out);
+
+  const T& top() const { return data[0]; }
+  // 按存储顺序（不是堆序）遍历所有元素
+  const T* begin() const { return data; }
+  const T* end() const { return data + count; }
+  bool empty() const { return count == 0; }
+  std::size_t size() const { return count; }
+  void reserve(std::size_t n);
+  void clear();
+  // 把存储区按 pop 的顺序（从好到差）排序。有序数组本身就满足堆性质，排序后仍是合法的堆，
+  // begin()/end() 随即按堆序遍历
+  void sort();
+
+private:
+  void up(std::size_t index);
+  void down(std::size_t index);
+  void make_heap();
+  void make_heap(std::size_t old_count);
+
+  void steal(Heap& rhs) {
+    data = rhs.data, count = rhs.count, cap = rhs.cap;
+    rhs.data = nullptr, rhs.count = rhs.cap = 0;
+  }
+  void release();
+  // 把现有元素搬到容量为 n 的 fresh 中并释放旧缓冲区
+  void relocate(T* fresh, std::size_t n);
+
+  // data 指向第一个有效元素，其前面是 Arity-1 个未构造的填充槽位。
+  static T* allocate(std::size_t n) {
+    void* raw = ::operator new((n + Arity - 1) * sizeof(T), std::align_val_t(cache_line));
+    return static_cast<T*>(raw) + (Arity - 1);
+  }
+  static void deallocate(T* p) {
+    if (p) ::operator delete(p - (Arity - 1), std::align_val_t(cache_line));
+  }
+
+private:
+  T* data = nullptr;
+  std::size_t count = 0;
+  std::size_t cap = 0;
+  Compare compare;
+};
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::up(std::size_t index) {
+  // 空穴上移：只在最后落位时移动一次 val，而不是逐层 swap。
+  T val = std::move(data[index]);
+  while (index > 0) {
+    std::size_t parent = (index - 1) / Arity;
+    if (!compare(data[parent], val)) break;
+    data[index] = std::move(data[parent]);
+    index = parent;
+  }
+  data[index] = std::move(val);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::down(std::size_t index) {
+  T val = std::move(data[index]);
+  while (true) {
+    std::size_t first = index * Arity + 1;
+    if (first >= count) break;
+    std::size_t last = first + Arity < count ? first + Arity : count;
+    std::size_t best = first;
+    for (std::size_t i = first + 1; i < last; ++i)
+      if (compare(data[best], data[i])) best = i;
+    if (!compare(val, data[best])) break;
+    data[index] = std::move(data[best]);
+    index = best;
+  }
+  data[index] = std::move(val);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+template <typename... Args>
+void Heap<T, Compare, Arity>::emplace(Args&&... args) {
+  if (count == cap) {
+    // 参数可能引用堆里的元素，先在新缓冲区里构造好，再搬走并释放旧元素
+    std::size_t n = cap ? cap * 2 : Arity * 4;
+    T* fresh = allocate(n);
+    try {
+      new (fresh + count) T(std::forward<Args>(args)...);
+    } catch (...) {
+      deallocate(fresh);
+      throw;
+    }
+    relocate(fresh, n);
+  } else {
+    new (data + count) T(std::forward<Args>(args)...);
+  }
+  up(count++);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+T Heap<T, Compare, Arity>::pop() {
+  T val = std::move(data[0]);
+  if (--count > 0) {
+    data[0] = std::move(data[count]);
+    data[count].~T();
+    down(0);
+  } else {
+    data[0].~T();
+  }
+
+  return val;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+T Heap<T, Compare, Arity>::replace_top(T val) {
+  std::swap(data[0], val);
+  down(0);
+
+  return val;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+template <typename InputIt>
+void Heap<T, Compare, Arity>::push_range(InputIt first, InputIt last) {
+  std::size_t old_count = count;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                  typename std::iterator_traits<InputIt>::iterator_category>) {
+    std::size_t n = std::distance(first, last);
+    if (count + n > cap) {
+      // 区间可能指向堆自己的元素，同 emplace：先复制到新缓冲区，再搬走旧元素
+      std::size_t fresh_cap = count + n > cap * 2 ? count + n : cap * 2;
+      T* fresh = allocate(fresh_cap);
+      std::size_t i = 0;
+      try {
+        for (; first != last; ++first, ++i) new (fresh + count + i) T(*first);
+      } catch (...) {
+        while (i) fresh[count + --i].~T();
+        deallocate(fresh);
+        throw;
+      }
+      relocate(fresh, fresh_cap);
+      count += n;
+    } else {
+      for (; first != last; ++first) new (data + count++) T(*first);
+    }
+  } else {
+    for (; first != last; ++first) {
+      if (count == cap) reserve(cap ? cap * 2 : Arity * 4);
+      new (data + count++) T(*first);
+    }
+  }
+  make_heap(old_count);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+template <typename OutputIt>
+std::size_t Heap<T, Compare, Arity>::pop_n(std::size_t k, OutputIt out) {
+  std::size_t n = k < count ? k : count;
+  for (std::size_t i = 0; i < n; ++i) *out++ = pop();
+  return n;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::reserve(std::size_t n) {
+  if (n <= cap) return;
+  relocate(allocate(n), n);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::relocate(T* fresh, std::size_t n) {
+  for (std::size_t i = 0; i < count; ++i) {
+    new (fresh + i) T(std::move_if_noexcept(data[i]));
+    data[i].~T();
+  }
+  deallocate(data);
+  data = fresh;
+  cap = n;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::clear() {
+  for (std::size_t i = 0; i < count; ++i) data[i].~T();
+  count = 0;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::sort() {
+  std::sort(data, data + count, [this](const T& a, const T& b) { return compare(b, a); });
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::release() {
+  clear();
+  deallocate(data);
+  data = nullptr;
+  cap = 0;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::make_heap() {
+  // Floyd 建堆：从最后一个非叶子节点开始逐个 down，O(n)。
+  if (count < 2) return;
+  for (std::size_t i = (count - 2) / Arity + 1; i > 0; --i)
+    down(i - 1);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void Heap<T, Compare, Arity>::make_heap(std::size_t old_count) {
+  // [0, old_count) 已经是堆，新追加了 k 个元素。
+  // 逐个上浮最坏 O(k * depth)，整体重建 O(n + k)；前者更贵时就重建。
+  std::size_t k = count - old_count;
+  std::size_t depth = 1;
+  for (std::size_t n = count; n > 1; n /= Arity) ++depth;
+  if (k * depth >= count) {
+    make_heap();
+  } else {
+    for (std::size_t i = old_count; i < count; ++i) up(i);
+  }
+}
+
+#endif
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "indexed_heap.h"
+
+struct Edge {
+  int to;
+  long long w;
+};
+
+// 每个节点在堆中最多出现一次，松弛时用 decrease_key 代替重复 push。
+std::vector<long long> dijkstra(const std::vector<std::vector<Edge>>& g, int src) {
+  const long long inf = std::numeric_limits<long long>::max();
+  using Queue = IndexedHeap<std::pair<long long, int>, std::greater<std::pair<long long, int>>, 4>;
+
+  std::vector<long long> dist(g.size(), inf);
+  std::vector<Queue::handle> where(g.size(), Queue::npos);
+  Queue q;
+  q.reserve(g.size());
+
+  dist[src] = 0;
+  where[src] = q.push({0, src});
+  while (!q.empty()) {
+    int u = q.pop().second;
+    for (const Edge& e : g[u]) {
+      long long nd = dist[u] + e.w;
+      if (nd >= dist[e.to]) continue;
+      dist[e.to] = nd;
+      // 已出队的节点距离不会再变小，所以 where 非空就一定还在堆里
+      if (where[e.to] != Queue::npos)
+        q.decrease_key(where[e.to], {nd, e.to});
+      else
+        where[e.to] = q.push({nd, e.to});
+    }
+  }
+
+  return dist;
+}
+
+int main() {
+  std::vector<std::vector<Edge>> g(6);
+  auto add = [&](int a, int b, long long w) { g[a].push_back({b, w}); g[b].push_back({a, w}); };
+  add(0, 1, 7); add(0, 2, 9); add(0, 5, 14); add(1, 2, 10); add(1, 3, 15);
+  add(2, 3, 11); add(2, 5, 2); add(3, 4, 6); add(4, 5, 9);
+
+  std::vector<long long> dist = dijkstra(g, 0);
+  for (std::size_t i = 0; i < dist.size(); ++i)
+    std::cout << i << ": " << dist[i] << std::endl;
+
+  IndexedHeap<int> h;
+  auto a = h.push(3), b = h.push(1), c = h.push(4);
+  h.push(1), h.push(5);
+  h.decrease_key(b, 9);
+  h.erase(c);
+  std::cout << "contains erased: " << h.contains(c) << ", a = " << h.key(a) << std::endl;
+  while (!h.empty()) std::cout << h.pop() << " ";
+  std::cout << std::endl;
+
+  return 0;
+}
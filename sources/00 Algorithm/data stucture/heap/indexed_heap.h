@@ -0,0 +1,171 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// 可寻址的 d 叉堆：push 返回一个稳定的 handle，之后可以通过 handle
+// 修改或删除仍在堆中的元素。下标规则与 Heap 相同（0 起始，Arity 叉）。
+// pos[handle] 记录元素当前在 data 中的位置，在 up/down 每次移动元素时同步更新，
+// 因此 decrease_key/erase 都是 O(log n)，且除了 push 时的扩容外不做任何分配。
+// 被弹出或删除的 handle 会进入空闲链表，下一次 push 时复用；链表直接存在
+// 空闲 handle 自己的 pos 槽位里，pop/erase 不分配内存。
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 2>
+class IndexedHeap {
+  static_assert(Arity >= 2, "Arity must be at least 2");
+
+public:
+  using handle = std::size_t;
+  static constexpr handle npos = static_cast<handle>(-1);
+
+  IndexedHeap(const Compare& cmp = Compare()) : compare(cmp) {}
+
+  handle push(const T& val) { return emplace(val); }
+  handle push(T&& val) { return emplace(std::move(val)); }
+  template <typename... Args>
+  handle emplace(Args&&... args);
+  T pop();
+
+  // 把 handle 的键改成 val，且 val 的优先级不低于原来的键（对小根堆即“减小”）。
+  void decrease_key(handle h, const T& val);
+  // 任意方向修改键。
+  void update(handle h, const T& val);
+  T erase(handle h);
+
+  bool contains(handle h) const { return h < pos.size() && !(pos[h] & free_bit); }
+  const T& key(handle h) const { return data[pos[h]].val; }
+  const T& top() const { return data[0].val; }
+  handle top_handle() const { return data[0].id; }
+  bool empty() const { return data.empty(); }
+  std::size_t size() const { return data.size(); }
+  void reserve(std::size_t n) { data.reserve(n), pos.reserve(n); }
+
+private:
+  // 空闲 handle 的 pos 槽位最高位为 1，其余位是链表中下一个空闲 handle 加一（0 表示链表结束）
+  static constexpr std::size_t free_bit = ~(npos >> 1);
+
+  struct Entry {
+    T val;
+    handle id;
+  };
+
+  void up(std::size_t index);
+  void down(std::size_t index);
+  void place(std::size_t index, Entry&& e) {
+    data[index] = std::move(e);
+    pos[data[index].id] = index;
+  }
+  T remove_at(std::size_t index);
+
+private:
+  std::vector<Entry> data;
+  std::vector<std::size_t> pos;  // handle -> data 下标；空闲时见 free_bit
+  handle free_head = npos;
+  Compare compare;
+};
+
+template <typename T, typename Compare, std::size_t Arity>
+void IndexedHeap<T, Compare, Arity>::up(std::size_t index) {
+  Entry e = std::move(data[index]);
+  while (index > 0) {
+    std::size_t parent = (index - 1) / Arity;
+    if (!compare(data[parent].val, e.val)) break;
+    place(index, std::move(data[parent]));
+    index = parent;
+  }
+  place(index, std::move(e));
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void IndexedHeap<T, Compare, Arity>::down(std::size_t index) {
+  std::size_t n = data.size();
+  Entry e = std::move(data[index]);
+  while (true) {
+    std::size_t first = index * Arity + 1;
+    if (first >= n) break;
+    std::size_t last = first + Arity < n ? first + Arity : n;
+    std::size_t best = first;
+    for (std::size_t i = first + 1; i < last; ++i)
+      if (compare(data[best].val, data[i].val)) best = i;
+    if (!compare(e.val, data[best].val)) break;
+    place(index, std::move(data[best]));
+    index = best;
+  }
+  place(index, std::move(e));
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+template <typename... Args>
+typename IndexedHeap<T, Compare, Arity>::handle IndexedHeap<T, Compare, Arity>::emplace(Args&&... args) {
+  handle id = free_head;
+  if (id != npos) {
+    data.push_back(Entry{T(std::forward<Args>(args)...), id});
+    free_head = (pos[id] & ~free_bit) - 1;
+  } else {
+    id = pos.size();
+    pos.push_back(npos);
+    try {
+      data.push_back(Entry{T(std::forward<Args>(args)...), id});
+    } catch (...) {
+      pos.pop_back();
+      throw;
+    }
+  }
+  up(data.size() - 1);
+  return id;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+T IndexedHeap<T, Compare, Arity>::remove_at(std::size_t index) {
+  handle id = data[index].id;
+  T val = std::move(data[index].val);
+  pos[id] = free_bit | (free_head + 1);
+  free_head = id;
+
+  std::size_t last = data.size() - 1;
+  if (index != last) {
+    place(index, std::move(data[last]));
+    data.pop_back();
+    // 填进来的末尾元素可能需要上浮也可能需要下沉
+    if (index > 0 && compare(data[(index - 1) / Arity].val, data[index].val)) up(index);
+    else down(index);
+  } else {
+    data.pop_back();
+  }
+
+  return val;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+T IndexedHeap<T, Compare, Arity>::pop() {
+  return remove_at(0);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+T IndexedHeap<T, Compare, Arity>::erase(handle h) {
+  assert(contains(h));
+  return remove_at(pos[h]);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void IndexedHeap<T, Compare, Arity>::decrease_key(handle h, const T& val) {
+  assert(contains(h) && !compare(val, key(h)));
+  std::size_t index = pos[h];
+  data[index].val = val;
+  up(index);
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+void IndexedHeap<T, Compare, Arity>::update(handle h, const T& val) {
+  assert(contains(h));
+  std::size_t index = pos[h];
+  bool raise = compare(data[index].val, val);
+  data[index].val = val;
+  if (raise) up(index);
+  else down(index);
+}
+
+#endif
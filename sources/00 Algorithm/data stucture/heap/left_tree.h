@@ -0,0 +1,134 @@
+#ifndef LEFT_TREE_H
+#define LEFT_TREE_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "../node_pool.h"
+
+// 左偏树（leftist heap）：可合并堆，merge/push/pop 都是 O(log n)。
+// dist 是节点到最近空孩子的距离（null 为 0），左偏性质要求 dist(left) >= dist(right)，
+// 所以右链长度不超过 log(n+1)，合并只沿两棵树的右链进行。
+// 节点来自每棵树自己的 NodePool；merge 时用 absorb 接管对方的内存池，
+// 因此 merge 和 pop 都不会调用全局 new。
+// Compare 与 Heap 相同：默认 std::less，堆顶为最大值。
+template <typename T, typename Compare = std::less<T>>
+class LeftTree {
+public:
+  LeftTree(const Compare& cmp = Compare()) : compare(cmp) {}
+  LeftTree(const std::vector<T>& in, const Compare& cmp = Compare());
+  LeftTree(const LeftTree&) = delete;
+  LeftTree& operator=(const LeftTree&) = delete;
+  LeftTree(LeftTree&& rhs) noexcept
+      : root(rhs.root), count(rhs.count), pool(std::move(rhs.pool)), compare(std::move(rhs.compare)) {
+    rhs.root = nullptr, rhs.count = 0;
+  }
+  ~LeftTree() { clear(); }
+
+  // 把 rhs 的所有元素并入本堆，rhs 变为空
+  void merge(LeftTree& rhs);
+  void push(const T& val) { emplace(val); }
+  void push(T&& val) { emplace(std::move(val)); }
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    root = meld(root, pool.create(std::forward<Args>(args)...));
+    ++count;
+  }
+  T pop();
+
+  const T& top() const { return root->val; }
+  bool empty() const { return root == nullptr; }
+  std::size_t size() const { return count; }
+  void clear();
+
+  class TreeNode {
+  public:
+    template <typename... Args>
+    TreeNode(Args&&... args) : val(std::forward<Args>(args)...) {}
+    T val;
+    int dist = 1;
+    TreeNode* left = nullptr;
+    TreeNode* right = nullptr;
+  };
+
+private:
+  static int dist(const TreeNode* node) { return node ? node->dist : 0; }
+  TreeNode* meld(TreeNode* a, TreeNode* b);
+
+private:
+  TreeNode* root = nullptr;
+  std::size_t count = 0;
+  NodePool<TreeNode> pool;
+  Compare compare;
+};
+
+template <typename T, typename Compare>
+LeftTree<T, Compare>::LeftTree(const std::vector<T>& in, const Compare& cmp) : compare(cmp) {
+  // 逐轮两两合并，总代价 O(n)
+  std::vector<TreeNode*> nodes;
+  nodes.reserve(in.size());
+  for (const T& val : in) nodes.push_back(pool.create(val));
+  while (nodes.size() > 1) {
+    std::size_t half = 0;
+    for (std::size_t i = 0; i + 1 < nodes.size(); i += 2) nodes[half++] = meld(nodes[i], nodes[i + 1]);
+    if (nodes.size() & 1) nodes[half++] = nodes.back();
+    nodes.resize(half);
+  }
+  root = nodes.empty() ? nullptr : nodes[0];
+  count = in.size();
+}
+
+template <typename T, typename Compare>
+typename LeftTree<T, Compare>::TreeNode* LeftTree<T, Compare>::meld(TreeNode* a, TreeNode* b) {
+  if (!a) return b;
+  if (!b) return a;
+  if (compare(a->val, b->val)) std::swap(a, b);
+  a->right = meld(a->right, b);
+  if (dist(a->left) < dist(a->right)) std::swap(a->left, a->right);
+  a->dist = dist(a->right) + 1;
+
+  return a;
+}
+
+template <typename T, typename Compare>
+void LeftTree<T, Compare>::merge(LeftTree& rhs) {
+  if (this == &rhs || rhs.empty()) return;
+  pool.absorb(rhs.pool);
+  root = meld(root, rhs.root);
+  count += rhs.count;
+  rhs.root = nullptr, rhs.count = 0;
+}
+
+template <typename T, typename Compare>
+T LeftTree<T, Compare>::pop() {
+  TreeNode* node = root;
+  root = meld(node->left, node->right);
+  --count;
+  T val = std::move(node->val);
+  pool.destroy(node);
+
+  return val;
+}
+
+template <typename T, typename Compare>
+void LeftTree<T, Compare>::clear() {
+  // 左子树不断右旋到右链上，不用递归也不用额外的栈
+  TreeNode* node = root;
+  while (node) {
+    if (node->left) {
+      TreeNode* l = node->left;
+      node->left = l->right;
+      l->right = node;
+      node = l;
+    } else {
+      TreeNode* r = node->right;
+      pool.destroy(node);
+      node = r;
+    }
+  }
+  root = nullptr;
+  count = 0;
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef MULTI_QUEUE_H
+#define MULTI_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <thread>
+#include "heap.h"
+
+// 松弛优先队列（MultiQueue, Rihani/Sanders/Dementiev 2015）。
+// 由 c*P 个 Heap 分片组成，每个分片一把自旋 try-lock：
+//   push: 随机挑一个分片，抢不到锁就换一个；
+//   pop : 随机挑两个分片，同时 try-lock 后比较堆顶，从较优的那个弹出。
+// 顺序是松弛的：pop 返回的元素不一定是全局最优。对 m = c*P 个分片，
+// 被弹出元素的期望排名误差为 O(m)，且以高概率为 O(m log m)；
+// 即比它更优的元素平均不超过 O(m) 个。c 越大争用越少，但误差越大，常取 c = 2~4。
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class MultiQueue {
+public:
+  MultiQueue(std::size_t threads, std::size_t c = 2, const Compare& cmp = Compare())
+      : count(threads * c < 2 ? 2 : threads * c), shards(new Shard[count]), compare(cmp) {}
+
+  void push(const T& val) { emplace(val); }
+  void push(T&& val) { emplace(std::move(val)); }
+  template <typename... Args>
+  void emplace(Args&&... args);
+  // 所有分片都为空时返回 std::nullopt。
+  std::optional<T> pop();
+
+  // 并发修改时只是近似值。
+  std::size_t size() const;
+  std::size_t shard_count() const { return count; }
+
+private:
+  // 每个分片独占 cache line，避免相邻分片的锁互相伪共享。
+  struct alignas(64) Shard {
+    std::atomic<bool> locked{false};
+    // 不加锁即可读取的空/非空提示，让 pop 跳过空分片而不去抢锁。
+    std::atomic<bool> has_top{false};
+    std::atomic<std::size_t> size{0};
+    Heap<T, Compare, Arity> heap;
+
+    bool try_lock() {
+      return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+    }
+    void unlock() { locked.store(false, std::memory_order_release); }
+    void publish() {
+      size.store(heap.size(), std::memory_order_relaxed);
+      has_top.store(!heap.empty(), std::memory_order_release);
+    }
+  };
+
+  std::size_t random_shard() {
+    thread_local std::minstd_rand rng(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return rng() % count;
+  }
+  std::optional<T> pop_from(Shard& s);
+
+private:
+  std::size_t count;
+  std::unique_ptr<Shard[]> shards;
+  Compare compare;
+};
+
+template <typename T, typename Compare, std::size_t Arity>
+template <typename... Args>
+void MultiQueue<T, Compare, Arity>::emplace(Args&&... args) {
+  T val(std::forward<Args>(args)...);
+  while (true) {
+    Shard& s = shards[random_shard()];
+    if (!s.try_lock()) continue;
+    s.heap.push(std::move(val));
+    s.publish();
+    s.unlock();
+    return;
+  }
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+std::optional<T> MultiQueue<T, Compare, Arity>::pop_from(Shard& s) {
+  if (s.heap.empty()) return std::nullopt;
+  std::optional<T> val(s.heap.pop());
+  s.publish();
+  return val;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+std::optional<T> MultiQueue<T, Compare, Arity>::pop() {
+  // 先做有限次随机双选；多次都落在空分片上时再顺序扫一遍，确认真的为空。
+  for (std::size_t attempt = 0; attempt < 4 * count; ++attempt) {
+    Shard& a = shards[random_shard()];
+    Shard& b = shards[random_shard()];
+    bool ha = a.has_top.load(std::memory_order_acquire);
+    bool hb = b.has_top.load(std::memory_order_acquire);
+    if (!ha && !hb) continue;
+
+    Shard* first = ha ? &a : &b;
+    Shard* second = ha && hb ? &b : nullptr;
+    if (second && first != second) {
+      // 两个锁都拿到才能安全读取 top 进行比较
+      if (!first->try_lock()) continue;
+      if (!second->try_lock()) {
+        first->unlock();
+        continue;
+      }
+      bool take_second = !second->heap.empty() &&
+                         (first->heap.empty() || compare(first->heap.top(), second->heap.top()));
+      Shard* winner = take_second ? second : first;
+      (take_second ? first : second)->unlock();
+      std::optional<T> val = pop_from(*winner);
+      winner->unlock();
+      if (val) return val;
+    } else {
+      if (!first->try_lock()) continue;
+      std::optional<T> val = pop_from(*first);
+      first->unlock();
+      if (val) return val;
+    }
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    Shard& s = shards[i];
+    while (!s.try_lock()) std::this_thread::yield();
+    std::optional<T> val = pop_from(s);
+    s.unlock();
+    if (val) return val;
+  }
+  return std::nullopt;
+}
+
+template <typename T, typename Compare, std::size_t Arity>
+std::size_t MultiQueue<T, Compare, Arity>::size() const {
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < count; ++i) n += shards[i].size.load(std::memory_order_relaxed);
+  return n;
+}
+
+#endif
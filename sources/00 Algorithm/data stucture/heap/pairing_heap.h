@@ -0,0 +1,162 @@
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "../node_pool.h"
+
+// 配对堆（pairing heap）：多叉树，用“左孩子右兄弟”表示。
+// push/merge/decrease_key 只做一次 link，O(1)；pop 对根的孩子做两趟配对合并，摊还 O(log n)。
+// push 返回节点指针作为 handle，元素出堆前一直有效，可用于 decrease_key。
+// 接口、内存池的用法与 LeftTree 相同。
+template <typename T, typename Compare = std::less<T>>
+class PairingHeap {
+public:
+  class TreeNode {
+  public:
+    template <typename... Args>
+    TreeNode(Args&&... args) : val(std::forward<Args>(args)...) {}
+    T val;
+    TreeNode* child = nullptr;
+    TreeNode* sibling = nullptr;
+    TreeNode* prev = nullptr;  // 第一个孩子指向父亲，其余指向左兄弟
+  };
+  using handle = TreeNode*;
+
+  PairingHeap(const Compare& cmp = Compare()) : compare(cmp) {}
+  PairingHeap(const PairingHeap&) = delete;
+  PairingHeap& operator=(const PairingHeap&) = delete;
+  PairingHeap(PairingHeap&& rhs) noexcept
+      : root(rhs.root), count(rhs.count), pool(std::move(rhs.pool)), compare(std::move(rhs.compare)) {
+    rhs.root = nullptr, rhs.count = 0;
+  }
+  ~PairingHeap() { clear(); }
+
+  // 把 rhs 的所有元素并入本堆，rhs 变为空；rhs 的 handle 继续有效
+  void merge(PairingHeap& rhs);
+  handle push(const T& val) { return emplace(val); }
+  handle push(T&& val) { return emplace(std::move(val)); }
+  template <typename... Args>
+  handle emplace(Args&&... args) {
+    TreeNode* node = pool.create(std::forward<Args>(args)...);
+    root = link(root, node);
+    ++count;
+    return node;
+  }
+  T pop();
+  // val 的优先级不能低于原来的值（对小根堆即“减小”）
+  void decrease_key(handle h, const T& val);
+
+  const T& top() const { return root->val; }
+  bool empty() const { return root == nullptr; }
+  std::size_t size() const { return count; }
+  void clear();
+
+private:
+  TreeNode* link(TreeNode* a, TreeNode* b);
+  TreeNode* combine(TreeNode* first);
+
+private:
+  TreeNode* root = nullptr;
+  std::size_t count = 0;
+  NodePool<TreeNode> pool;
+  Compare compare;
+};
+
+template <typename T, typename Compare>
+typename PairingHeap<T, Compare>::TreeNode* PairingHeap<T, Compare>::link(TreeNode* a, TreeNode* b) {
+  // 较差的一方成为较优一方的第一个孩子
+  if (!a) return b;
+  if (!b) return a;
+  if (compare(a->val, b->val)) std::swap(a, b);
+  b->prev = a;
+  b->sibling = a->child;
+  if (a->child) a->child->prev = b;
+  a->child = b;
+  a->sibling = a->prev = nullptr;
+
+  return a;
+}
+
+template <typename T, typename Compare>
+typename PairingHeap<T, Compare>::TreeNode* PairingHeap<T, Compare>::combine(TreeNode* first) {
+  // 第一趟：从左到右两两 link，结果用 sibling 反向串成一条链；
+  // 第二趟：从右到左依次 link 到累积结果上。
+  TreeNode* pairs = nullptr;
+  while (first) {
+    TreeNode* a = first;
+    TreeNode* b = a->sibling;
+    first = b ? b->sibling : nullptr;
+    a->sibling = a->prev = nullptr;
+    if (b) b->sibling = b->prev = nullptr;
+    TreeNode* t = link(a, b);
+    t->sibling = pairs;
+    pairs = t;
+  }
+
+  TreeNode* result = nullptr;
+  while (pairs) {
+    TreeNode* next = pairs->sibling;
+    pairs->sibling = nullptr;
+    result = link(result, pairs);
+    pairs = next;
+  }
+
+  return result;
+}
+
+template <typename T, typename Compare>
+void PairingHeap<T, Compare>::merge(PairingHeap& rhs) {
+  if (this == &rhs || rhs.empty()) return;
+  pool.absorb(rhs.pool);
+  root = link(root, rhs.root);
+  count += rhs.count;
+  rhs.root = nullptr, rhs.count = 0;
+}
+
+template <typename T, typename Compare>
+T PairingHeap<T, Compare>::pop() {
+  TreeNode* node = root;
+  root = combine(node->child);
+  --count;
+  T val = std::move(node->val);
+  pool.destroy(node);
+
+  return val;
+}
+
+template <typename T, typename Compare>
+void PairingHeap<T, Compare>::decrease_key(handle h, const T& val) {
+  h->val = val;
+  if (h == root) return;
+
+  // 把以 h 为根的子树从兄弟链上摘下来，再与根 link
+  if (h->prev->child == h) h->prev->child = h->sibling;
+  else h->prev->sibling = h->sibling;
+  if (h->sibling) h->sibling->prev = h->prev;
+  h->sibling = h->prev = nullptr;
+  root = link(root, h);
+}
+
+template <typename T, typename Compare>
+void PairingHeap<T, Compare>::clear() {
+  // 把 child 链不断拼到 sibling 链的前面，不用递归也不用额外的栈
+  TreeNode* node = root;
+  while (node) {
+    if (node->child) {
+      TreeNode* c = node->child;
+      node->child = c->sibling;
+      c->sibling = node;
+      node = c;
+    } else {
+      TreeNode* next = node->sibling;
+      pool.destroy(node);
+      node = next;
+    }
+  }
+  root = nullptr;
+  count = 0;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 单调小根堆（radix heap）：要求每次 push 的键都不小于最近一次 pop 出的键，
+// 适用于定时器、整数边权 Dijkstra 这类键单调不减的场景。
+// 桶 i（i >= 1）存放与 last 最高不同位为第 i-1 位的元素，桶 0 存放等于 last 的元素。
+// pop 时若桶 0 为空，就找到第一个非空桶，以其中最小键为新的 last，
+// 把整桶重新分配到更低的桶里。每个元素最多下移 bits 次，
+// 因此摊还复杂度为 O(log C)，且只有对桶的顺序读写，没有随机访问。
+template <typename Key, typename Value>
+class RadixHeap {
+  static_assert(std::is_integral_v<Key> && std::is_unsigned_v<Key>, "Key must be an unsigned integer");
+
+public:
+  using value_type = std::pair<Key, Value>;
+  static constexpr std::size_t bits = std::numeric_limits<Key>::digits;
+
+  void push(Key key, Value value) {
+    assert(key >= last);
+    buckets[bucket_of(key)].emplace_back(key, std::move(value));
+    ++count;
+  }
+  value_type pop();
+  // 堆顶；可能触发一次桶的重新分配，所以不是 const
+  const value_type& top() {
+    pull();
+    return buckets[0].back();
+  }
+
+  bool empty() const { return count == 0; }
+  std::size_t size() const { return count; }
+
+private:
+  std::size_t bucket_of(Key key) const {
+    Key diff = key ^ last;
+    return diff == 0 ? 0 : bits - static_cast<std::size_t>(count_leading_zeros(diff));
+  }
+  static int count_leading_zeros(Key x) {
+    if constexpr (sizeof(Key) <= sizeof(unsigned))
+      return __builtin_clz(x) - (std::numeric_limits<unsigned>::digits - bits);
+    else if constexpr (sizeof(Key) <= sizeof(unsigned long))
+      return __builtin_clzl(x) - (std::numeric_limits<unsigned long>::digits - bits);
+    else
+      return __builtin_clzll(x) - (std::numeric_limits<unsigned long long>::digits - bits);
+  }
+  void pull();
+
+private:
+  std::vector<value_type> buckets[bits + 1];
+  Key last = 0;
+  std::size_t count = 0;
+};
+
+template <typename Key, typename Value>
+void RadixHeap<Key, Value>::pull() {
+  assert(count > 0);
+  if (!buckets[0].empty()) return;
+
+  std::size_t i = 1;
+  while (buckets[i].empty()) ++i;
+
+  Key min = buckets[i][0].first;
+  for (const value_type& e : buckets[i])
+    if (e.first < min) min = e.first;
+  last = min;
+
+  // 新 last 下，这些元素的最高不同位一定低于 i-1，全部落入更低的桶
+  for (value_type& e : buckets[i]) buckets[bucket_of(e.first)].push_back(std::move(e));
+  buckets[i].clear();
+}
+
+template <typename Key, typename Value>
+typename RadixHeap<Key, Value>::value_type RadixHeap<Key, Value>::pop() {
+  pull();
+  value_type val = std::move(buckets[0].back());
+  buckets[0].pop_back();
+  --count;
+
+  return val;
+}
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef SIMD_HEAP_H
+#define SIMD_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_HEAP_X86 1
+#endif
+
+// 8 叉整数/浮点堆。布局与 Heap<T, Compare, 8> 相同（头部 7 个填充槽位，
+// 存储区 64 字节对齐），因此每组 8 个兄弟恰好是一个对齐的 32 字节块，
+// down() 用一次 AVX2 比较+归约选出最优孩子，代替 7 次标量比较。
+// 末尾不满 8 个的那一组用“最差”值补齐，使 SIMD 总能读满 8 个槽位。
+// 运行时检测 CPU 是否支持 AVX2，不支持（或非 x86）时走标量路径。
+// 仅支持 int32_t / uint32_t / float，Compare 只能是 std::less（大根堆）或
+// std::greater（小根堆）；float 键不能是 NaN。
+namespace simd_heap_detail {
+
+// 返回 p[0..8) 中最优元素的下标，并列时取最小下标。
+template <typename T, bool Max>
+inline std::size_t best_of8_scalar(const T* p) {
+  std::size_t best = 0;
+  for (std::size_t i = 1; i < 8; ++i)
+    if (Max ? p[best] < p[i] : p[i] < p[best]) best = i;
+  return best;
+}
+
+#ifdef SIMD_HEAP_X86
+// 把 8 个 lane 归约成全都等于最值的向量，再和原向量比较，取第一个相等的 lane。
+#define SIMD_HEAP_INT_KERNEL(NAME, TYPE, OP)                                         \
+  __attribute__((target("avx2"))) inline std::size_t NAME(const TYPE* p) {           \
+    __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(p));              \
+    __m256i m = OP(v, _mm256_permute2x128_si256(v, v, 1));                           \
+    m = OP(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));                     \
+    m = OP(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));                     \
+    int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, m)));    \
+    return __builtin_ctz(mask);                                                      \
+  }
+
+#define SIMD_HEAP_FLOAT_KERNEL(NAME, OP)                                             \
+  __attribute__((target("avx2"))) inline std::size_t NAME(const float* p) {          \
+    __m256 v = _mm256_load_ps(p);                                                    \
+    __m256 m = OP(v, _mm256_permute2f128_ps(v, v, 1));                               \
+    m = OP(m, _mm256_permute_ps(m, _MM_SHUFFLE(1, 0, 3, 2)));                        \
+    m = OP(m, _mm256_permute_ps(m, _MM_SHUFFLE(2, 3, 0, 1)));                        \
+    int mask = _mm256_movemask_ps(_mm256_cmp_ps(v, m, _CMP_EQ_OQ));                  \
+    return __builtin_ctz(mask);                                                      \
+  }
+
+SIMD_HEAP_INT_KERNEL(max_of8_avx2, std::int32_t, _mm256_max_epi32)
+SIMD_HEAP_INT_KERNEL(min_of8_avx2, std::int32_t, _mm256_min_epi32)
+SIMD_HEAP_INT_KERNEL(max_of8_avx2, std::uint32_t, _mm256_max_epu32)
+SIMD_HEAP_INT_KERNEL(min_of8_avx2, std::uint32_t, _mm256_min_epu32)
+SIMD_HEAP_FLOAT_KERNEL(max_of8_avx2, _mm256_max_ps)
+SIMD_HEAP_FLOAT_KERNEL(min_of8_avx2, _mm256_min_ps)
+
+#undef SIMD_HEAP_INT_KERNEL
+#undef SIMD_HEAP_FLOAT_KERNEL
+
+inline bool has_avx2() {
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+}
+#endif
+
+template <typename T, bool Max>
+inline std::size_t best_of8(const T* p) {
+#ifdef SIMD_HEAP_X86
+  if (has_avx2()) return Max ? max_of8_avx2(p) : min_of8_avx2(p);
+#endif
+  return best_of8_scalar<T, Max>(p);
+}
+
+}  // namespace simd_heap_detail
+
+template <typename T, typename Compare = std::less<T>>
+class SimdHeap {
+  static_assert(std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::uint32_t> ||
+                    std::is_same_v<T, float>,
+                "SimdHeap supports int32_t, uint32_t and float keys");
+  static_assert(std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::greater<T>>,
+                "SimdHeap supports std::less and std::greater only");
+
+public:
+  static constexpr std::size_t Arity = 8;
+  static constexpr bool Max = std::is_same_v<Compare, std::less<T>>;
+
+  SimdHeap() = default;
+  SimdHeap(const SimdHeap&) = delete;
+  SimdHeap& operator=(const SimdHeap&) = delete;
+  ~SimdHeap() { deallocate(data); }
+
+  void push(T val);
+  T pop();
+
+  T top() const { return data[0]; }
+  bool empty() const { return count == 0; }
+  std::size_t size() const { return count; }
+  void reserve(std::size_t n);
+
+private:
+  void up(std::size_t index, T val);
+  void down(T val);
+
+  // 排在所有合法值之后的填充值
+  static constexpr T worst() {
+    if constexpr (std::is_same_v<T, float>)
+      return Max ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+    else
+      return Max ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+  }
+  bool better(T a, T b) const { return Max ? b < a : a < b; }
+
+  static T* allocate(std::size_t n) {
+    void* raw = ::operator new((n + Arity - 1) * sizeof(T), std::align_val_t(64));
+    return static_cast<T*>(raw) + (Arity - 1);
+  }
+  static void deallocate(T* p) {
+    if (p) ::operator delete(p - (Arity - 1), std::align_val_t(64));
+  }
+
+private:
+  T* data = nullptr;
+  std::size_t count = 0;
+  std::size_t cap = 0;  // 总是 Arity 组对齐后的 8k+1 形式：最后一组之后不再有槽位
+};
+
+template <typename T, typename Compare>
+void SimdHeap<T, Compare>::up(std::size_t index, T val) {
+  while (index > 0) {
+    std::size_t parent = (index - 1) / Arity;
+    if (!better(val, data[parent])) break;
+    data[index] = data[parent];
+    index = parent;
+  }
+  data[index] = val;
+}
+
+template <typename T, typename Compare>
+void SimdHeap<T, Compare>::down(T val) {
+  std::size_t index = 0;
+  while (true) {
+    std::size_t first = index * Arity + 1;
+    if (first >= count) break;
+    std::size_t best = first + simd_heap_detail::best_of8<T, Max>(data + first);
+    if (!better(data[best], val)) break;
+    data[index] = data[best];
+    index = best;
+  }
+  data[index] = val;
+}
+
+template <typename T, typename Compare>
+void SimdHeap<T, Compare>::push(T val) {
+  if (count == cap) reserve(cap ? cap * 2 : 64);
+  up(count++, val);
+}
+
+template <typename T, typename Compare>
+T SimdHeap<T, Compare>::pop() {
+  T val = data[0];
+  T last = data[--count];
+  data[count] = worst();
+  if (count > 0) down(last);
+
+  return val;
+}
+
+template <typename T, typename Compare>
+void SimdHeap<T, Compare>::reserve(std::size_t n) {
+  // 容量取 8k+1，保证最后一个孩子组 [8i+1, 8i+9) 完整落在存储区内
+  n = (n + Arity - 1) / Arity * Arity + 1;
+  if (n <= cap) return;
+  T* fresh = allocate(n);
+  for (std::size_t i = 0; i < count; ++i) fresh[i] = data[i];
+  for (std::size_t i = count; i < n; ++i) fresh[i] = worst();
+  deallocate(data);
+  data = fresh;
+  cap = n;
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef SKEW_HEAP_H
+#define SKEW_HEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "../node_pool.h"
+
+// 斜堆（skew heap）：左偏树的自调整版本，不保存 dist，
+// 每次沿右链合并后无条件交换左右孩子，摊还 O(log n)。
+// 单次合并的右链可能很长，所以 meld 写成自顶向下的迭代形式。
+// 接口、内存池的用法与 LeftTree 相同。
+template <typename T, typename Compare = std::less<T>>
+class SkewHeap {
+public:
+  SkewHeap(const Compare& cmp = Compare()) : compare(cmp) {}
+  SkewHeap(const SkewHeap&) = delete;
+  SkewHeap& operator=(const SkewHeap&) = delete;
+  SkewHeap(SkewHeap&& rhs) noexcept
+      : root(rhs.root), count(rhs.count), pool(std::move(rhs.pool)), compare(std::move(rhs.compare)) {
+    rhs.root = nullptr, rhs.count = 0;
+  }
+  ~SkewHeap() { clear(); }
+
+  // 把 rhs 的所有元素并入本堆，rhs 变为空
+  void merge(SkewHeap& rhs);
+  void push(const T& val) { emplace(val); }
+  void push(T&& val) { emplace(std::move(val)); }
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    root = meld(root, pool.create(std::forward<Args>(args)...));
+    ++count;
+  }
+  T pop();
+
+  const T& top() const { return root->val; }
+  bool empty() const { return root == nullptr; }
+  std::size_t size() const { return count; }
+  void clear();
+
+  class TreeNode {
+  public:
+    template <typename... Args>
+    TreeNode(Args&&... args) : val(std::forward<Args>(args)...) {}
+    T val;
+    TreeNode* left = nullptr;
+    TreeNode* right = nullptr;
+  };
+
+private:
+  TreeNode* meld(TreeNode* a, TreeNode* b);
+
+private:
+  TreeNode* root = nullptr;
+  std::size_t count = 0;
+  NodePool<TreeNode> pool;
+  Compare compare;
+};
+
+template <typename T, typename Compare>
+typename SkewHeap<T, Compare>::TreeNode* SkewHeap<T, Compare>::meld(TreeNode* a, TreeNode* b) {
+  if (!a) return b;
+  if (!b) return a;
+  if (compare(a->val, b->val)) std::swap(a, b);
+
+  // 递归版本：a->right = meld(a->right, b); swap(a->left, a->right)
+  // 这里把“合并结果”直接挂到 cur 的左边，原来的左孩子换到右边
+  TreeNode* top = a;
+  TreeNode* cur = a;
+  a = a->right;
+  while (a && b) {
+    if (compare(a->val, b->val)) std::swap(a, b);
+    cur->right = cur->left;
+    cur->left = a;
+    cur = a;
+    a = a->right;
+  }
+  cur->right = cur->left;
+  cur->left = a ? a : b;
+
+  return top;
+}
+
+template <typename T, typename Compare>
+void SkewHeap<T, Compare>::merge(SkewHeap& rhs) {
+  if (this == &rhs || rhs.empty()) return;
+  pool.absorb(rhs.pool);
+  root = meld(root, rhs.root);
+  count += rhs.count;
+  rhs.root = nullptr, rhs.count = 0;
+}
+
+template <typename T, typename Compare>
+T SkewHeap<T, Compare>::pop() {
+  TreeNode* node = root;
+  root = meld(node->left, node->right);
+  --count;
+  T val = std::move(node->val);
+  pool.destroy(node);
+
+  return val;
+}
+
+template <typename T, typename Compare>
+void SkewHeap<T, Compare>::clear() {
+  TreeNode* node = root;
+  while (node) {
+    if (node->left) {
+      TreeNode* l = node->left;
+      node->left = l->right;
+      l->right = node;
+      node = l;
+    } else {
+      TreeNode* r = node->right;
+      pool.destroy(node);
+      node = r;
+    }
+  }
+  root = nullptr;
+  count = 0;
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "top_k.h"
+
+struct Record {
+  double score;
+  long long id;
+  bool operator<(const Record& rhs) const { return score < rhs.score; }
+};
+
+int main() {
+  // 4 个线程各自扫描一段流，最后合并局部 top-10
+  const int threads = 4;
+  const long long per_thread = 1000000;
+  std::vector<TopK<Record, 10>> partial(threads);
+  std::vector<long long> accepted(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::mt19937_64 rng(t);
+      std::uniform_real_distribution<double> dist(0, 1);
+      for (long long i = 0; i < per_thread; ++i)
+        accepted[t] += partial[t].push(Record{dist(rng), t * per_thread + i});
+    });
+  }
+  for (std::thread& w : workers) w.join();
+
+  TopK<Record, 10> total;
+  long long kept = 0;
+  for (int t = 0; t < threads; ++t) {
+    total.merge(partial[t]);
+    kept += accepted[t];
+  }
+
+  for (const Record& r : total.sorted())
+    std::cout << r.id << "\t" << r.score << std::endl;
+  std::cout << "candidates that reached the heap: " << kept << " / " << threads * per_thread << std::endl;
+
+  return 0;
+}
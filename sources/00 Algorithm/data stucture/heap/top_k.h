@@ -0,0 +1,70 @@
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "heap.h"
+
+// 流式 top-K：只保留按 Compare 排序最大的 K 个元素，内存 O(K)。
+// 内部是一个容量固定为 K 的反序堆，堆顶就是当前保留的最差元素（门槛）。
+// 堆满后，新元素先和门槛比较一次，不够好的直接丢弃，不会做任何 sift；
+// 够好的用 replace_top 顶替门槛，只做一次 down。
+template <typename T, std::size_t K, typename Compare = std::less<T>, std::size_t Arity = 4>
+class TopK {
+  static_assert(K > 0, "K must be positive");
+
+  // 把“更差”的元素排到堆顶
+  struct Worse {
+    Compare compare;
+    bool operator()(const T& a, const T& b) const { return compare(b, a); }
+  };
+
+public:
+  TopK(const Compare& cmp = Compare()) : compare(cmp), heap(Worse{cmp}) { heap.reserve(K); }
+
+  // 返回元素是否被保留
+  bool push(const T& val) {
+    if (heap.size() < K) {
+      heap.push(val);
+      return true;
+    }
+    if (!compare(heap.top(), val)) return false;
+    heap.replace_top(val);
+    return true;
+  }
+  bool push(T&& val) {
+    if (heap.size() < K) {
+      heap.push(std::move(val));
+      return true;
+    }
+    if (!compare(heap.top(), val)) return false;
+    heap.replace_top(std::move(val));
+    return true;
+  }
+
+  // 合并另一个（例如另一个线程的）局部结果，结果仍是两者并集的 top-K。
+  void merge(const TopK& rhs) {
+    for (const T& val : rhs.heap) push(val);
+  }
+
+  // 当前门槛：比它差（或相等）的元素不会再被接受；full() 为真时才有意义。
+  const T& threshold() const { return heap.top(); }
+  bool full() const { return heap.size() == K; }
+  bool empty() const { return heap.empty(); }
+  std::size_t size() const { return heap.size(); }
+
+  // 从好到差排好序的结果
+  std::vector<T> sorted() const {
+    std::vector<T> out(heap.begin(), heap.end());
+    std::sort(out.begin(), out.end(), [this](const T& a, const T& b) { return compare(b, a); });
+    return out;
+  }
+
+private:
+  Compare compare;
+  Heap<T, Worse, Arity> heap;
+};
+
+#endif
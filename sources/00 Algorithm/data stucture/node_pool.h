@@ -0,0 +1,148 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// 定长节点的内存池：按块（slab）向系统申请内存，块内顺序切分（bump），
+// 释放的节点挂到空闲链表上优先复用。只有切分到新块时才会调用全局 new。
+// 块之间用侵入式链表串起来，absorb() 可以 O(1) 接管另一个池的全部内存，
+// 方便可合并的数据结构在 merge 时把对方的节点一并收编。
+// 析构时直接归还所有块，不会调用仍然存活的 T 的析构函数，
+// 需要析构的节点应由使用者先 destroy()。
+template <typename T>
+class NodePool {
+public:
+  explicit NodePool(std::size_t first_block = 64) : next_cap(first_block ? first_block : 1) {}
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+  NodePool(NodePool&& rhs) noexcept { steal(rhs); }
+  NodePool& operator=(NodePool&& rhs) noexcept {
+    if (this != &rhs) {
+      release();
+      steal(rhs);
+    }
+    return *this;
+  }
+  ~NodePool() { release(); }
+
+  template <typename... Args>
+  T* create(Args&&... args) {
+    Slot* s = free_list;
+    if (s) {
+      free_list = s->next;
+      if (!free_list) free_tail = nullptr;
+    } else {
+      if (bump == bump_end) grow();
+      s = bump++;
+    }
+    ++live_count;
+    return new (s->storage) T(std::forward<Args>(args)...);
+  }
+
+  // 一次切出 n 个地址连续、尚未构造的槽位，调用者逐个 placement new。
+  // 之后它们和 create() 得到的节点一样，用 destroy() 单独归还。
+  // 当前块剩余不足 n 个时另开一块，剩余部分不再切分。
+  T* allocate_contiguous(std::size_t n) {
+    static_assert(sizeof(Slot) == sizeof(T), "contiguous slots must have the stride of T");
+    if (static_cast<std::size_t>(bump_end - bump) < n) grow(n);
+    T* p = reinterpret_cast<T*>(bump);
+    bump += n;
+    live_count += n;
+    return p;
+  }
+
+  void destroy(T* p) {
+    p->~T();
+    Slot* s = reinterpret_cast<Slot*>(p);
+    s->next = free_list;
+    if (!free_list) free_tail = s;
+    free_list = s;
+    --live_count;
+  }
+
+  // 接管 rhs 的所有块和空闲节点，rhs 变为空池。rhs 中尚未切分的尾部不再复用。
+  void absorb(NodePool& rhs) {
+    if (this == &rhs) return;
+    if (rhs.blocks) {
+      rhs.blocks_tail->next = blocks;
+      blocks = rhs.blocks;
+      if (!blocks_tail) blocks_tail = rhs.blocks_tail;
+    }
+    if (rhs.free_list) {
+      rhs.free_tail->next = free_list;
+      if (!free_list) free_tail = rhs.free_tail;
+      free_list = rhs.free_list;
+    }
+    live_count += rhs.live_count;
+    reserved += rhs.reserved;
+    if (rhs.next_cap > next_cap) next_cap = rhs.next_cap;
+    rhs.reset();
+  }
+
+  // 归还所有块；调用前必须保证没有需要析构的存活节点
+  void release() {
+    while (blocks) {
+      Block* next = blocks->next;
+      ::operator delete(blocks, std::align_val_t(block_align));
+      blocks = next;
+    }
+    std::size_t cap = next_cap;
+    reset();
+    next_cap = cap;
+  }
+
+  std::size_t live() const { return live_count; }
+  std::size_t reserved_bytes() const { return reserved; }
+
+private:
+  union Slot {
+    Slot* next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+  struct Block {
+    Block* next;
+  };
+  static constexpr std::size_t block_align = alignof(Slot) > alignof(Block) ? alignof(Slot) : alignof(Block);
+  static constexpr std::size_t header = (sizeof(Block) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+
+  void grow(std::size_t min = 0) {
+    std::size_t cap = next_cap > min ? next_cap : min;
+    std::size_t bytes = header + cap * sizeof(Slot);
+    Block* b = static_cast<Block*>(::operator new(bytes, std::align_val_t(block_align)));
+    b->next = blocks;
+    blocks = b;
+    if (!blocks_tail) blocks_tail = b;
+    bump = reinterpret_cast<Slot*>(reinterpret_cast<char*>(b) + header);
+    bump_end = bump + cap;
+    reserved += bytes;
+    // 块大小翻倍增长，上限 64K 个节点
+    if (next_cap < (std::size_t(1) << 16)) next_cap *= 2;
+  }
+  void reset() {
+    blocks = blocks_tail = nullptr;
+    free_list = free_tail = bump = bump_end = nullptr;
+    live_count = reserved = 0;
+  }
+  void steal(NodePool& rhs) {
+    blocks = rhs.blocks, blocks_tail = rhs.blocks_tail;
+    free_list = rhs.free_list, free_tail = rhs.free_tail;
+    bump = rhs.bump, bump_end = rhs.bump_end;
+    live_count = rhs.live_count, reserved = rhs.reserved, next_cap = rhs.next_cap;
+    rhs.reset();
+  }
+
+private:
+  Block* blocks = nullptr;
+  Block* blocks_tail = nullptr;
+  Slot* free_list = nullptr;
+  Slot* free_tail = nullptr;
+  Slot* bump = nullptr;
+  Slot* bump_end = nullptr;
+  std::size_t live_count = 0;
+  std::size_t reserved = 0;
+  std::size_t next_cap = 64;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include "../../00 Algorithm/data stucture/epoch.h"
+
+// 无锁的多生产者多消费者栈（Treiber 栈）。
+// 栈顶是一个 64 位的原子字：低 48 位是节点指针，高 16 位是每次成功修改都加一的版本号，
+// push/pop 各用一次 CAS 替换整个字，同一个指针被弹出又压回（ABA）时版本号不同，CAS 会失败。
+// 弹出的节点交给 EpochDomain 延迟释放：pop 在 pin 住的临界区里读取栈顶节点的 next，
+// 节点不会在读的过程中被释放，它的地址也不会被新节点重用。
+// 对栈顶的 CAS 失败说明竞争激烈，这时改到消除数组（elimination array）上碰运气：
+// push 把节点放进一个随机的槽位等一小会儿，同时到来的 pop 直接把它取走，
+// 一对 push/pop 互相抵消，不再争抢栈顶；等不到就撤回节点，重新去栈顶 CAS。
+// 要求用户态地址不超过 48 位（x86-64、AArch64 的默认配置）。
+template <typename T>
+class ConcurrentStack {
+public:
+    ConcurrentStack() : _head(0) {}
+    ConcurrentStack(const ConcurrentStack &) = delete;
+    ConcurrentStack& operator=(const ConcurrentStack &) = delete;
+    // 析构时不应再有其他线程访问这个栈
+    ~ConcurrentStack();
+
+    void push(const T &elem) { push_node(new Node(elem)); }
+    void push(T &&elem) { push_node(new Node(std::move(elem))); }
+    template <typename... Args>
+    void emplace(Args&&... args) { push_node(new Node(std::forward<Args>(args)...)); }
+
+    // 栈空时返回 nullopt
+    std::optional<T> pop();
+
+    // 只是某一时刻的快照，其他线程随时可能改变它
+    bool empty() const { return ptr(_head.load(std::memory_order_acquire)) == 0; }
+private:
+    struct Node {
+        template <typename... Args>
+        explicit Node(Args&&... args) : _val(std::forward<Args>(args)...), _next(0) {}
+        T _val;
+        Node *_next;
+    };
+    static_assert(sizeof(void*) == 8, "tagged pointers need a 64-bit address space");
+
+    static constexpr int tag_shift = 48;
+    static constexpr std::uint64_t ptr_mask = (std::uint64_t(1) << tag_shift) - 1;
+    static Node* ptr(std::uint64_t word) { return reinterpret_cast<Node*>(word & ptr_mask); }
+    static std::uint64_t next_word(std::uint64_t word, Node *pt) {
+        return reinterpret_cast<std::uintptr_t>(pt) | ((word >> tag_shift) + 1) << tag_shift;
+    }
+
+    void push_node(Node *pt);
+    // 在消除数组上交换：push 成功交出 pt 时返回 true；pop 取到节点时返回它，否则返回 0
+    bool eliminate_push(Node *pt);
+    Node* eliminate_pop();
+    static std::size_t random_slot();
+
+    static constexpr std::size_t eliminate_slots = 8;
+    static constexpr int eliminate_spins = 128;
+    struct alignas(64) Slot {
+        std::atomic<Node*> offer{0};
+    };
+
+    alignas(64) std::atomic<std::uint64_t> _head;
+    Slot _slots[eliminate_slots];
+    EpochDomain _epochs;
+};
+
+template <typename T>
+ConcurrentStack<T>::~ConcurrentStack() {
+    Node *pt = ptr(_head.load());
+    while (pt) {
+        Node *next = pt->_next;
+        delete pt;
+        pt = next;
+    }
+}
+
+template <typename T>
+void ConcurrentStack<T>::push_node(Node *pt) {
+    // 消除数组上只比较节点地址，pin 住保证等待期间地址不会被重用
+    EpochDomain::Guard guard = _epochs.pin();
+    std::uint64_t head = _head.load(std::memory_order_relaxed);
+    while (true) {
+        pt->_next = ptr(head);
+        if (_head.compare_exchange_weak(head, next_word(head, pt), std::memory_order_release,
+                                        std::memory_order_relaxed))
+            return;
+        if (eliminate_push(pt))
+            return;
+        head = _head.load(std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+std::optional<T> ConcurrentStack<T>::pop() {
+    EpochDomain::Guard guard = _epochs.pin();
+    std::uint64_t head = _head.load(std::memory_order_acquire);
+    while (true) {
+        Node *top = ptr(head);
+        if (!top)
+            return std::nullopt;
+        // top 可能已经被别的线程弹出，但在临界区内不会被释放，读 _next 是安全的
+        if (_head.compare_exchange_weak(head, next_word(head, top->_next), std::memory_order_acquire,
+                                        std::memory_order_acquire)) {
+            std::optional<T> elem(std::move(top->_val));
+            _epochs.retire(top);
+            return elem;
+        }
+        if (Node *pt = eliminate_pop()) {
+            std::optional<T> elem(std::move(pt->_val));
+            _epochs.retire(pt);
+            return elem;
+        }
+        head = _head.load(std::memory_order_acquire);
+    }
+}
+
+template <typename T>
+bool ConcurrentStack<T>::eliminate_push(Node *pt) {
+    std::atomic<Node*> &offer = _slots[random_slot()].offer;
+    Node *empty = 0;
+    if (!offer.compare_exchange_strong(empty, pt, std::memory_order_release, std::memory_order_relaxed))
+        return false;
+
+    for (int i = 0; i < eliminate_spins; ++i)
+        if (offer.load(std::memory_order_acquire) != pt)
+            return true;    // 被某个 pop 取走了
+
+    // 超时撤回；撤回失败说明就在这一刻被取走了
+    return !offer.compare_exchange_strong(pt, 0, std::memory_order_acquire, std::memory_order_acquire);
+}
+
+template <typename T>
+typename ConcurrentStack<T>::Node* ConcurrentStack<T>::eliminate_pop() {
+    std::atomic<Node*> &offer = _slots[random_slot()].offer;
+    Node *pt = offer.load(std::memory_order_acquire);
+    if (pt && offer.compare_exchange_strong(pt, 0, std::memory_order_acquire, std::memory_order_relaxed))
+        return pt;
+    return 0;
+}
+
+template <typename T>
+std::size_t ConcurrentStack<T>::random_slot() {
+    // 每个线程一个 xorshift 生成器，初值取自这个 thread_local 变量自己的地址，各线程不同
+    thread_local std::uint32_t state = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&state)) | 1;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state % eliminate_slots;
+}
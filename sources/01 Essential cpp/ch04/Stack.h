@@ -1,27 +1,318 @@
-#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 
+// Stack 的索引策略，决定 find/count 怎样实现：
+//   stack_no_index    不建索引（默认），顺序扫描整个栈，没有额外开销；
+//   stack_hash_index  维护一张 元素 -> 个数 的哈希表，push/pop 时增量更新，
+//                     find/count 平均 O(1)。每个不同的元素在表里多存一份拷贝，
+//                     占用的内存由 index_memory() 报告。
+struct stack_no_index {
+    template <typename T>
+    class table {
+    public:
+        static constexpr bool indexed = false;
+        void add(const T &) {}
+        void remove(const T &) {}
+        int count(const T &) const { return 0; }
+        void clear() {}
+        std::size_t memory() const { return 0; }
+    };
+};
+
+template <template <typename> class Hash = std::hash, template <typename> class KeyEqual = std::equal_to>
+struct stack_hash_index {
+    template <typename T>
+    class table {
+    public:
+        static constexpr bool indexed = true;
+        void add(const T &elem) { ++_counts[elem]; }
+        void remove(const T &elem) {
+            typename map_type::iterator it = _counts.find(elem);
+            if (--it->second == 0)
+                _counts.erase(it);
+        }
+        int count(const T &elem) const {
+            typename map_type::const_iterator it = _counts.find(elem);
+            return it == _counts.end() ? 0 : it->second;
+        }
+        void clear() { _counts.clear(); }
+        // 估算：桶数组加上每个节点（next 指针、缓存的哈希值、键值对），
+        // 不含元素自己在堆上的内存（例如长字符串的缓冲区）
+        std::size_t memory() const {
+            return _counts.bucket_count() * sizeof(void*) +
+                   _counts.size() * (sizeof(void*) + sizeof(std::size_t) + sizeof(typename map_type::value_type));
+        }
+    private:
+        typedef std::unordered_map<T, int, Hash<T>, KeyEqual<T>> map_type;
+        map_type _counts;
+    };
+};
+
+// 通用的栈。前 InlineN 个元素直接放在对象内部的缓冲区里，深度不超过 InlineN 的栈
+// 从不分配堆内存；超出后按两倍换到 Allocator 分配的堆上，此后不再回到内部缓冲区。
+// 元素数达到构造时给出的上限 bound 时 full() 为真，push/emplace 返回 false。
+// Index 为 stack_hash_index 时 find/count 查哈希表，见上面的索引策略。
+template <typename T, std::size_t InlineN = 8, typename Allocator = std::allocator<T>,
+          typename Index = stack_no_index>
 class Stack
 {
 private:
-    std::vector<std::string> _stack;
+    typedef std::allocator_traits<Allocator> traits;
 public:
-    bool push(const std::string&elem);
-    bool pop(std::string &elem);
-    bool peek(std::string &elem);
-    bool find(const std::string &elem);
-    int count(const std::string &elem);
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef Allocator allocator_type;
+
+    explicit Stack(size_type bound = traits::max_size(Allocator()), const Allocator &alloc = Allocator())
+        : _alloc(alloc), _data(inline_data()), _size(0), _capacity(InlineN), _bound(bound) {}
+    Stack(const Stack &rhs);
+    Stack(Stack &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+    ~Stack();
+    Stack& operator=(const Stack &rhs);
+    Stack& operator=(Stack &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    bool push(const T &elem) { return emplace(elem); }
+    bool push(T &&elem) { return emplace(std::move(elem)); }
+    template <typename... Args>
+    bool emplace(Args&&... args);
+
+    // 栈空时返回 nullopt；栈顶元素被移动出来
+    std::optional<T> pop();
+    bool pop(T &elem);
+    bool peek(T &elem) const;
+    bool find(const T &elem) const;
+    int count(const T &elem) const;
 
-    bool empty();
-    bool full();
+    bool empty() const;
+    bool full() const;
 
-    int size() {return _stack.size();}
+    size_type size() const { return _size; }
+    size_type bound() const { return _bound; }
+    // 索引额外占用的字节数，不建索引时为 0
+    std::size_t index_memory() const { return _index.memory(); }
+    void clear();
+private:
+    T* inline_data() { return std::launder(reinterpret_cast<T*>(_inline)); }
+    bool on_heap() const { return _data != reinterpret_cast<const T*>(_inline); }
+    // 容量扩到至少 cap，元素移动到新的堆内存
+    void reserve(size_type cap);
+    // 归还堆内存，回到内部缓冲区；调用前元素必须已经析构
+    void release();
+
+    Allocator _alloc;
+    typename Index::template table<T> _index;
+    T *_data;
+    size_type _size;
+    size_type _capacity;
+    size_type _bound;
+    alignas(T) unsigned char _inline[(InlineN ? InlineN : 1) * sizeof(T)];
 };
 
-inline bool Stack::empty() {
-    return _stack.empty();
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+Stack<T, InlineN, Allocator, Index>::Stack(const Stack &rhs)
+    : _alloc(traits::select_on_container_copy_construction(rhs._alloc)), _index(rhs._index),
+      _data(inline_data()), _size(0), _capacity(InlineN), _bound(rhs._bound) {
+    reserve(rhs._size);
+    for (; _size < rhs._size; ++_size)
+        traits::construct(_alloc, _data + _size, rhs._data[_size]);
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+Stack<T, InlineN, Allocator, Index>::Stack(Stack &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+    : _alloc(rhs._alloc), _index(std::move(rhs._index)),
+      _data(inline_data()), _size(0), _capacity(InlineN), _bound(rhs._bound) {
+    rhs._index.clear();
+    if (rhs.on_heap()) {
+        // 堆上的元素直接接管指针
+        _data = rhs._data;
+        _size = rhs._size;
+        _capacity = rhs._capacity;
+        rhs._data = rhs.inline_data();
+        rhs._size = 0;
+        rhs._capacity = InlineN;
+    } else {
+        for (; _size < rhs._size; ++_size)
+            traits::construct(_alloc, _data + _size, std::move(rhs._data[_size]));
+        rhs.clear();
+    }
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+Stack<T, InlineN, Allocator, Index>::~Stack() {
+    clear();
+    release();
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+Stack<T, InlineN, Allocator, Index>& Stack<T, InlineN, Allocator, Index>::operator=(const Stack &rhs) {
+    if (this != &rhs) {
+        clear();
+        _bound = rhs._bound;
+        reserve(rhs._size);
+        for (; _size < rhs._size; ++_size)
+            traits::construct(_alloc, _data + _size, rhs._data[_size]);
+        _index = rhs._index;
+    }
+
+    return *this;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+Stack<T, InlineN, Allocator, Index>& Stack<T, InlineN, Allocator, Index>::operator=(Stack &&rhs)
+    noexcept(std::is_nothrow_move_constructible<T>::value) {
+    if (this == &rhs) return *this;
+
+    clear();
+    release();
+    _bound = rhs._bound;
+    _index = std::move(rhs._index);
+    rhs._index.clear();
+    if (rhs.on_heap() && (traits::propagate_on_container_move_assignment::value || _alloc == rhs._alloc)) {
+        if constexpr (traits::propagate_on_container_move_assignment::value) _alloc = rhs._alloc;
+        _data = rhs._data;
+        _size = rhs._size;
+        _capacity = rhs._capacity;
+        rhs._data = rhs.inline_data();
+        rhs._size = 0;
+        rhs._capacity = InlineN;
+    } else {
+        reserve(rhs._size);
+        for (; _size < rhs._size; ++_size)
+            traits::construct(_alloc, _data + _size, std::move(rhs._data[_size]));
+        rhs.clear();
+    }
+
+    return *this;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+template <typename... Args>
+bool Stack<T, InlineN, Allocator, Index>::emplace(Args&&... args) {
+    if (full())
+        return false;
+
+    if (_size == _capacity) {
+        // 参数可能引用栈里的元素，先构造好再扩容
+        T elem(std::forward<Args>(args)...);
+        reserve(std::min(_bound, std::max<size_type>(2 * _capacity, 4)));
+        traits::construct(_alloc, _data + _size, std::move(elem));
+    } else {
+        traits::construct(_alloc, _data + _size, std::forward<Args>(args)...);
+    }
+    ++_size;
+
+    if constexpr (Index::template table<T>::indexed) {
+        try {
+            _index.add(_data[_size - 1]);
+        } catch (...) {
+            traits::destroy(_alloc, _data + --_size);
+            throw;
+        }
+    }
+    return true;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+std::optional<T> Stack<T, InlineN, Allocator, Index>::pop() {
+    if (empty())
+        return std::nullopt;
+
+    _index.remove(_data[_size - 1]);
+    std::optional<T> elem(std::move(_data[_size - 1]));
+    traits::destroy(_alloc, _data + --_size);
+    return elem;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+bool Stack<T, InlineN, Allocator, Index>::pop(T &elem) {
+    if (empty())
+        return false;
+
+    _index.remove(_data[_size - 1]);
+    elem = std::move(_data[_size - 1]);
+    traits::destroy(_alloc, _data + --_size);
+    return true;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+bool Stack<T, InlineN, Allocator, Index>::peek(T &elem) const {
+    if (empty())
+        return false;
+
+    elem = _data[_size - 1];
+    return true;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+bool Stack<T, InlineN, Allocator, Index>::find(const T &elem) const {
+    if constexpr (Index::template table<T>::indexed)
+        return _index.count(elem) != 0;
+    return std::find(_data, _data + _size, elem) != _data + _size;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+int Stack<T, InlineN, Allocator, Index>::count(const T &elem) const {
+    if constexpr (Index::template table<T>::indexed)
+        return _index.count(elem);
+    return std::count(_data, _data + _size, elem);
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+void Stack<T, InlineN, Allocator, Index>::clear() {
+    while (_size)
+        traits::destroy(_alloc, _data + --_size);
+    _index.clear();
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+void Stack<T, InlineN, Allocator, Index>::reserve(size_type cap) {
+    if (cap <= _capacity)
+        return;
+
+    T *data = traits::allocate(_alloc, cap);
+    size_type i = 0;
+    try {
+        for (; i < _size; ++i)
+            traits::construct(_alloc, data + i, std::move_if_noexcept(_data[i]));
+    } catch (...) {
+        while (i)
+            traits::destroy(_alloc, data + --i);
+        traits::deallocate(_alloc, data, cap);
+        throw;
+    }
+
+    for (i = 0; i < _size; ++i)
+        traits::destroy(_alloc, _data + i);
+    release();
+    _data = data;
+    _capacity = cap;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+void Stack<T, InlineN, Allocator, Index>::release() {
+    if (on_heap())
+        traits::deallocate(_alloc, _data, _capacity);
+    _data = inline_data();
+    _capacity = InlineN;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+inline bool Stack<T, InlineN, Allocator, Index>::empty() const {
+    return _size == 0;
+}
+
+template <typename T, std::size_t InlineN, typename Allocator, typename Index>
+inline bool Stack<T, InlineN, Allocator, Index>::full() const {
+    return _size >= _bound;
 }
 
-inline bool Stack::full() {
-    return _stack.size() == _stack.max_size();
-}
\ No newline at end of file
+// 带哈希索引的栈，find/count 平均 O(1)
+template <typename T, std::size_t InlineN = 8>
+using IndexedStack = Stack<T, InlineN, std::allocator<T>, stack_hash_index<>>;
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ConcurrentStack.h"
+#include "Stack.h"
+
+// 共享工作栈的竞争测试：每个线程交替 push 和 pop，总操作数固定，分摊到 1 到 64 个线程。
+// 对比 mutex 保护的 Stack 与无锁的 ConcurrentStack（线程多于核数时消除数组才有机会配对）。
+// 用法：bench_concurrent_stack [总操作数]
+
+class LockedStack {
+public:
+    void push(long v) {
+        std::lock_guard<std::mutex> lock(_m);
+        _stack.push(v);
+    }
+    std::optional<long> pop() {
+        std::lock_guard<std::mutex> lock(_m);
+        return _stack.pop();
+    }
+private:
+    std::mutex _m;
+    Stack<long> _stack;
+};
+
+template <typename S>
+double run(int threads, long ops) {
+    S stack;
+    for (long i = 0; i < 1024; ++i)
+        stack.push(i);
+
+    long per_thread = ops / threads / 2;
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&stack, per_thread] {
+            for (long i = 0; i < per_thread; ++i) {
+                stack.push(i);
+                stack.pop();
+            }
+        });
+    for (std::thread &w : workers)
+        w.join();
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+    return per_thread * threads * 2 / secs.count() / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    long ops = argc > 1 ? std::atol(argv[1]) : 8000000;
+    std::cout << "threads\tmutex Mops/s\tlock-free Mops/s" << std::endl;
+    for (int threads = 1; threads <= 64; threads *= 2)
+        std::cout << threads << "\t" << run<LockedStack>(threads, ops) << "\t"
+                  << run<ConcurrentStack<long>>(threads, ops) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Stack.h"
+
+// 递归展开时的环检测：每压入一个名字之前先 find 一次，看它是否已经在展开路径上。
+// 普通 Stack 每次 find 都扫描整个栈，总代价是深度的平方；IndexedStack 每次 find 查哈希表。
+// 每种深度展开到底再全部弹出，重复若干轮，总操作数大致相同。
+// 用法：bench_stack_index [最大深度]
+
+template <typename F>
+double seconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+    return secs.count();
+}
+
+template <typename S>
+double expand(const std::vector<std::string> &names, std::size_t rounds, long long &cycles, std::size_t &index_bytes) {
+    return seconds([&] {
+        for (std::size_t r = 0; r < rounds; ++r) {
+            S stack;
+            for (const std::string &name : names) {
+                if (stack.find(name)) ++cycles;
+                stack.push(name);
+            }
+            index_bytes = stack.index_memory();
+            while (stack.pop()) {}
+        }
+    });
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t max_depth = argc > 1 ? std::atoll(argv[1]) : 16384;
+    std::cout << "depth\tstack ms\tindexed ms\tindex bytes\tbytes/elem" << std::endl;
+    for (std::size_t depth = 16; depth <= max_depth; depth *= 4) {
+        std::vector<std::string> names;
+        for (std::size_t i = 0; i < depth; ++i)
+            names.push_back("template/expand/" + std::to_string(i));
+        std::size_t rounds = std::max<std::size_t>(1, 1000000 / depth);
+
+        long long cycles = 0;
+        std::size_t plain_bytes = 0, index_bytes = 0;
+        double plain = expand<Stack<std::string>>(names, rounds, cycles, plain_bytes);
+        double indexed = expand<IndexedStack<std::string>>(names, rounds, cycles, index_bytes);
+        std::cout << depth << "\t" << plain * 1000 << "\t" << indexed * 1000 << "\t" << index_bytes << "\t"
+                  << index_bytes / depth << "\t(cycles " << cycles << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -1,142 +1,419 @@
 #include "BinaryTree.h"
+#include "../../00 Algorithm/data stucture/flat_tree.h"
+#include <algorithm>
+#include <future>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <thread>
 
 using namespace std;
 
-template <typename elemType>
-inline BinaryTree<elemType>::BinaryTree(const BinaryTree &rhs) {
-    copy(_root, rhs._root);
+template <typename elemType, typename BalancePolicy>
+inline BinaryTree<elemType, BalancePolicy>::BinaryTree(const BinaryTree &rhs) : _root(0), _size(0) {
+    clone(rhs);
 }
 
-template <typename elemType>
-inline BinaryTree<elemType>::~BinaryTree() {
+template <typename elemType, typename BalancePolicy>
+inline BinaryTree<elemType, BalancePolicy>::~BinaryTree() {
     clear();
 }
 
-template <typename elemType>
-inline BinaryTree<elemType>& BinaryTree<elemType>::operator=(const BinaryTree &rhs) {
+template <typename elemType, typename BalancePolicy>
+inline BinaryTree<elemType, BalancePolicy>& BinaryTree<elemType, BalancePolicy>::operator=(const BinaryTree &rhs) {
     if (this != &rhs) {
         clear();
-        copy(_root, rhs._root);
+        clone(rhs);
     }
 
     return *this;
 }
 
-template <typename elemType>
-void BinaryTree<elemType>::copy(BTnode<elemType> *tar, BTnode<elemType> *src) {
-    if (src) {
-        if (!tar) 
-            tar = new BTnode<elemType>(src->_val);
-        if (src->_left) {
-            tar->_left = new BTnode<elemType>(src->_left->_val);
-            copy(tar->_left, src->_left);
+template <typename elemType, typename BalancePolicy>
+inline BinaryTree<elemType, BalancePolicy>& BinaryTree<elemType, BalancePolicy>::operator=(BinaryTree &&rhs) noexcept {
+    if (this != &rhs) {
+        clear();
+        _root = rhs._root;
+        _size = rhs._size;
+        _nodes = std::move(rhs._nodes);
+        rhs._root = 0;
+        rhs._size = 0;
+    }
+
+    return *this;
+}
+
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::clone(const BinaryTree &rhs) {
+    if (!rhs._root) return;
+
+    node_type *slots = _nodes.allocate_contiguous(rhs._size);
+    // 节点不多时线程的开销比复制本身还大
+    unsigned threads = rhs._size >= (1 << 16) ? thread::hardware_concurrency() : 1;
+    int depth = 0;
+    while ((1u << depth) < threads) ++depth;
+    try {
+        _root = clone(rhs._root, slots, 0, depth);
+    } catch (...) {
+        // 调用时树是空的，池里只有这批槽位；已构造的节点都已析构，整池归还
+        _nodes.release();
+        throw;
+    }
+    _size = rhs._size;
+}
+
+// 一遍前序复制 src 子树到从 slot 开始的连续槽位，新节点沿 _parent 与原节点同步回溯，
+// 不需要递归也不需要栈
+template <typename elemType, typename BalancePolicy>
+BTnode<elemType, BalancePolicy>* BinaryTree<elemType, BalancePolicy>::clone(const node_type *src, node_type *slot, node_type *parent) {
+    node_type *first = slot;
+    try {
+        const node_type *s = src;
+        node_type *d = copy_node(s, slot++, parent);
+        node_type *root = d;
+
+        while (true) {
+            if (s->_left) {
+                s = s->_left;
+                d = d->_left = copy_node(s, slot++, d);
+            } else if (s->_right) {
+                s = s->_right;
+                d = d->_right = copy_node(s, slot++, d);
+            } else {
+                // 回到第一个从左边上来、且有右子树的祖先
+                while (s != src && (s == s->_parent->_right || !s->_parent->_right)) {
+                    s = s->_parent;
+                    d = d->_parent;
+                }
+                if (s == src) break;
+                s = s->_parent->_right;
+                d = d->_parent;
+                d = d->_right = copy_node(s, slot++, d);
+            }
+        }
+
+        return root;
+    } catch (...) {
+        // slot 在 copy_node 之前已经自增，构造失败的槽位是 slot - 1
+        destroy_slots(first, slot - 1);
+        throw;
+    }
+}
+
+// 前 depth 层每个节点把左子树交给新线程；左子树在前序中紧跟在节点之后，
+// 右子树从 slot + 1 + 左子树大小 开始，所以结果与单线程的前序布局完全一样
+template <typename elemType, typename BalancePolicy>
+BTnode<elemType, BalancePolicy>* BinaryTree<elemType, BalancePolicy>::clone(const node_type *src, node_type *slot,
+                                                                                node_type *parent, int depth) {
+    if (depth == 0) return clone(src, slot, parent);
+
+    node_type *d = copy_node(src, slot, parent);
+    size_t left = subtree_size(src->_left);
+    future<node_type*> l;
+    try {
+        if (src->_left)
+            l = async(launch::async, [=] { return clone(src->_left, slot + 1, d, depth - 1); });
+        if (src->_right)
+            d->_right = clone(src->_right, slot + 1 + left, d, depth - 1);
+    } catch (...) {
+        // 失败的一侧已经自行清理；还要等左子树的线程结束，它复制成功的话同样析构掉
+        if (l.valid()) {
+            try {
+                l.get();
+                destroy_slots(slot + 1, slot + 1 + left);
+            } catch (...) {}
         }
-        if (src->_right) {
-            tar->_right = new BTnode<elemType>(src->_right->_val);
-            copy(tar->_right, src->_right);
+        d->~node_type();
+        throw;
+    }
+    if (src->_left) {
+        try {
+            d->_left = l.get();
+        } catch (...) {
+            if (src->_right)
+                destroy_slots(slot + 1 + left, slot + 1 + left + subtree_size(src->_right));
+            d->~node_type();
+            throw;
         }
     }
+
+    return d;
 }
 
-template <typename elemType>
-inline void BinaryTree<elemType>::insert(const elemType &elem) {
-    if (_root == 0) 
-        _root = new BTnode<elemType>(elem);
-    else
-        _root->insert_value(elem);
+template <typename elemType, typename BalancePolicy>
+size_t BinaryTree<elemType, BalancePolicy>::subtree_size(const node_type *pt) {
+    size_t n = 0;
+    for (const node_type *cur = pt; cur; ) {
+        ++n;
+        if (cur->_left) {
+            cur = cur->_left;
+        } else if (cur->_right) {
+            cur = cur->_right;
+        } else {
+            while (cur != pt && (cur == cur->_parent->_right || !cur->_parent->_right))
+                cur = cur->_parent;
+            cur = cur == pt ? 0 : cur->_parent->_right;
+        }
+    }
+
+    return n;
 }
 
-template <typename elemType>
-inline void BinaryTree<elemType>::remove(const elemType &elem) {
-    if (_root) {
-        if (_root->_val == elem)
-            remove_root();
-        else
-            _root->remove_value(elem, _root);
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::insert(const elemType &elem) {
+    bool inserted = true;
+    node_type *pt;
+    if (_root == 0)
+        pt = _root = _nodes.create(elem);
+    else
+        pt = _root->insert_value(elem, _nodes, inserted);
+    if (inserted) ++_size;
+
+    if constexpr (is_same<BalancePolicy, treap_balance>::value) {
+        // 新节点按随机优先级向上旋转，恢复大根堆性质
+        if (inserted)
+            while (pt->_parent && pt->_parent->_priority < pt->_priority)
+                rotate_up(pt);
+    } else if constexpr (is_same<BalancePolicy, splay_balance>::value) {
+        splay(pt);
     }
 }
 
-template <typename elemType>
-inline void BinaryTree<elemType>::remove_root() {
-    if (!_root) return;
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::remove(const elemType &elem) {
+    node_type *pt = const_cast<node_type*>(locate(elem));
+    if (!pt) return;
 
-    BTnode<elemType> *root = _root;
-    if (!_root->_right) {
-        _root = _root->_left;
+    node_type *child;
+    if constexpr (is_same<BalancePolicy, treap_balance>::value) {
+        // 把优先级较大的孩子旋转上来，直到 pt 最多只剩一个孩子
+        while (pt->_left && pt->_right)
+            rotate_up(pt->_left->_priority > pt->_right->_priority ? pt->_left : pt->_right);
+        child = pt->_left ? pt->_left : pt->_right;
+    } else if constexpr (is_same<BalancePolicy, splay_balance>::value) {
+        // pt 转到根后，把左子树的最大元素转成左子树的根，右子树挂在它下面
+        splay(pt);
+        child = pt->_left;
+        if (!child) {
+            child = pt->_right;
+        } else {
+            node_type *max = child;
+            while (max->_right) max = max->_right;
+            child->_parent = 0;
+            _root = child;
+            splay(max);
+            max->_right = pt->_right;
+            if (max->_right) max->_right->_parent = max;
+            child = max;
+        }
+        pt->_parent = 0;
     } else {
-        _root = _root->_right;
-        if (root->_left) {
-            BTnode<elemType> *tmp = _root;
+        // 右子树顶替 pt，左子树挂到右子树最小的节点下
+        child = pt->_right;
+        if (!child) {
+            child = pt->_left;
+        } else if (pt->_left) {
+            node_type *tmp = child;
             while (tmp->_left) tmp = tmp->_left;
-            tmp->_left = root->_left;
+            tmp->_left = pt->_left;
+            tmp->_left->_parent = tmp;
+        }
+    }
+    if (child) child->_parent = pt->_parent;
+    replace_child(pt->_parent, pt, child);
+
+    _nodes.destroy(pt);
+    --_size;
+}
+
+template <typename elemType, typename BalancePolicy>
+template <typename K>
+const BTnode<elemType, BalancePolicy>* BinaryTree<elemType, BalancePolicy>::locate(const K &key) const {
+    const node_type *pt = _root;
+    while (pt) {
+        int c = three_way(key, pt->_val);
+        if (c == 0) break;
+        pt = c < 0 ? pt->_left : pt->_right;
+    }
+
+    return pt;
+}
+
+template <typename elemType, typename BalancePolicy>
+template <typename K>
+const BTnode<elemType, BalancePolicy>* BinaryTree<elemType, BalancePolicy>::access(const K &key) {
+    if constexpr (!is_same<BalancePolicy, splay_balance>::value) {
+        return locate(key);
+    } else {
+        node_type *pt = _root, *last = 0;
+        while (pt) {
+            int c = three_way(key, pt->_val);
+            if (c == 0) break;
+            last = pt;
+            pt = c < 0 ? pt->_left : pt->_right;
         }
+        if (pt || last) splay(pt ? pt : last);
+        return pt;
     }
-    delete root;
 }
 
-template <typename elemType>
-void BinaryTree<elemType>::clear(BTnode<elemType> *pt) {
-    if (pt) {
-        clear(pt->_left);
-        clear(pt->_right);
-        delete pt;
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::replace_child(node_type *parent, node_type *old, node_type *now) {
+    if (!parent) _root = now;
+    else if (parent->_left == old) parent->_left = now;
+    else parent->_right = now;
+}
+
+// pt 与父节点交换位置，中序不变
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::rotate_up(node_type *pt) {
+    node_type *parent = pt->_parent;
+    if (parent->_left == pt) {
+        parent->_left = pt->_right;
+        if (pt->_right) pt->_right->_parent = parent;
+        pt->_right = parent;
+    } else {
+        parent->_right = pt->_left;
+        if (pt->_left) pt->_left->_parent = parent;
+        pt->_left = parent;
     }
+    pt->_parent = parent->_parent;
+    parent->_parent = pt;
+    replace_child(pt->_parent, parent, pt);
 }
 
-template <typename elemType>
-void BinaryTree<elemType>::preorder() {
-    if (_root) 
-        _root->preorder(_root, cout);
+// 自底向上伸展：一字形先转父节点再转自己，之字形连转两次自己
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::splay(node_type *pt) {
+    while (node_type *parent = pt->_parent) {
+        if (node_type *grand = parent->_parent)
+            rotate_up((grand->_left == parent) == (parent->_left == pt) ? parent : pt);
+        rotate_up(pt);
+    }
+}
+
+template <typename elemType, typename BalancePolicy>
+int BinaryTree<elemType, BalancePolicy>::height() const {
+    int h = 0;
+    vector<const node_type*> level, below;
+    if (_root) level.push_back(_root);
+    while (!level.empty()) {
+        ++h;
+        below.clear();
+        for (const node_type *pt : level) {
+            if (pt->_left) below.push_back(pt->_left);
+            if (pt->_right) below.push_back(pt->_right);
+        }
+        level.swap(below);
+    }
+
+    return h;
 }
 
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::clear(node_type *pt) {
+    // 后序删除：先求出后继再删当前节点，后继只依赖父节点和右兄弟子树
+    const node_type *cur = first(pt, post_order);
+    while (cur) {
+        const node_type *nxt = cur == pt ? 0 : next(cur, post_order);
+        _nodes.destroy(const_cast<node_type*>(cur));
+        cur = nxt;
+    }
+}
 
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::preorder() {
+    for (preorder_iterator it(first(_root, pre_order)), end; it != end; ++it)
+        cout << *it << "  ";
+}
 
+template <typename elemType, typename BalancePolicy>
+void BinaryTree<elemType, BalancePolicy>::save_flat(const string &path) const {
+    write_flat_tree<elemType, int>(path, [this](auto visit) {
+        for (iterator it = begin(); it != end(); ++it)
+            visit(*it, it.count());
+    });
+}
 
-template <typename valType>
-void BTnode<valType>::insert_value(const valType &val) {
-    if (val == _val) {
-        _cnt++;
-        return;
+template <typename elemType, typename BalancePolicy>
+const BTnode<elemType, BalancePolicy>* BinaryTree<elemType, BalancePolicy>::first(const node_type *pt, order ord) {
+    if (!pt) return 0;
+    if (ord == in_order) {
+        while (pt->_left) pt = pt->_left;
+    } else if (ord == post_order) {
+        // 一直向下，能往左就往左，否则往右，直到叶子
+        while (pt->_left || pt->_right)
+            pt = pt->_left ? pt->_left : pt->_right;
     }
+    return pt;
+}
 
-    if (val < _val) {
-        if (!_left) _left = new BTnode<valType>(val);
-        else _left->insert_value(val);
-    } else {
-        if (!_right) _right = new BTnode<valType>(val);
-        else _right->insert_value(val);
+template <typename elemType, typename BalancePolicy>
+const BTnode<elemType, BalancePolicy>* BinaryTree<elemType, BalancePolicy>::next(const node_type *pt, order ord) {
+    const node_type *parent = pt->_parent;
+    if (ord == in_order) {
+        if (pt->_right) return first(pt->_right, in_order);
+        while (parent && pt == parent->_right) {
+            pt = parent;
+            parent = pt->_parent;
+        }
+        return parent;
     }
+    if (ord == pre_order) {
+        if (pt->_left) return pt->_left;
+        if (pt->_right) return pt->_right;
+        // 回溯到第一个从左边上来、且有右子树的祖先
+        while (parent && (pt == parent->_right || !parent->_right)) {
+            pt = parent;
+            parent = pt->_parent;
+        }
+        return parent ? parent->_right : 0;
+    }
+    // post_order：左孩子之后是右兄弟子树的第一个节点，否则是父节点
+    if (parent && pt == parent->_left && parent->_right)
+        return first(parent->_right, post_order);
+    return parent;
 }
 
-template <typename valType>
-void BTnode<valType>::remove_value(const valType &val, BTnode *& prev) {
-    if (val < _val) {
-        if (!_left) return;
-        else _left->remove_value(val, _left);
-    } else if (val > _val) {
-        if (!_right) return;
-        else _right->remove_value(val, _right);
-    } else {
-        if (_right) {
-            prev = _right;
-            if (_left) {
-                BTnode<valType> *tmp = prev;
-                while (tmp->_left) tmp = tmp->_left;
-                tmp->_left = _left;
-            }
-        } else prev = _left;
-        delete this;
+template <typename elemType, typename BalancePolicy>
+typename BinaryTree<elemType, BalancePolicy>::level_iterator& BinaryTree<elemType, BalancePolicy>::level_iterator::operator++() {
+    const node_type *pt = _queue[_head++];
+    if (pt->_left) _queue.push_back(pt->_left);
+    if (pt->_right) _queue.push_back(pt->_right);
+
+    // 已经出队的部分过半时整体前移，容量保持在最宽两层的量级
+    if (_head == _queue.size()) {
+        _queue.clear();
+        _head = 0;
+    } else if (_head >= 64 && _head * 2 >= _queue.size()) {
+        _queue.erase(_queue.begin(), _queue.begin() + _head);
+        _head = 0;
     }
+    return *this;
 }
 
-template <typename valType>
-void BTnode<valType>::preorder(BTnode *pt, ostream &os) const {
-    if (pt) {
-        os << pt->_val << "  ";
-        if (pt->_left) preorder(pt->_left, os);
-        if (pt->_right) preorder(pt->_right, os);
+
+
+
+template <typename valType, typename Policy>
+BTnode<valType, Policy>* BTnode<valType, Policy>::insert_value(const valType &val, NodePool<BTnode> &pool,
+                                                              bool &inserted) {
+    BTnode *pt = this;
+    while (true) {
+        int c = three_way(val, pt->_val);
+        if (c == 0) {
+            pt->_cnt++;
+            inserted = false;
+            return pt;
+        }
+
+        BTnode *&child = c < 0 ? pt->_left : pt->_right;
+        if (!child) {
+            child = pool.create(val, pt);
+            inserted = true;
+            return child;
+        }
+        pt = child;
     }
 }
 
@@ -173,5 +450,48 @@ int main() {
     bt2.preorder(); 
     cout << "\n\n";
 
+    BinaryTree<string> bt3(std::move(bt2));
+    cout << "moved " << bt3.size() << " names, source now "
+         << (bt2.empty() ? "empty" : "non-empty") << "\n\n";
+
+    bt.save_flat("/tmp/winnie.idx");
+    FlatTree<string, int> idx("/tmp/winnie.idx");
+    cout << "mapped: " << idx.size() << " names, Roo "
+         << (idx.contains("Roo") ? "found" : "missing") << ", Owl "
+         << (idx.contains("Owl") ? "found" : "missing") << endl;
+
+    bt.insert("Roo");
+    string_view query = "Roo/tenant-a";
+    cout << "Roo inserted " << bt.count(query.substr(0, 3)) << " times, Owl "
+         << (bt.contains("Owl") ? "present" : "absent") << endl;
+    cout << "\nInorder with counts: " << endl;
+    for (BinaryTree<string>::iterator it = bt.begin(); it != bt.end(); ++it)
+        cout << *it << "(" << it.count() << ")  ";
+    cout << "\nPostorder traversal: " << endl;
+    for (const string &name : bt.postorder_range())
+        cout << name << "  ";
+    cout << "\nLevel-order traversal: " << endl;
+    for (const string &name : bt.levelorder_range())
+        cout << name << "  ";
+    cout << "\nFirst name after K: "
+         << *find_if(bt.begin(), bt.end(), [](const string &name) { return name > "K"; }) << endl;
+
+    // 有序插入：不平衡时退化成链表，treap 保持对数深度，splay 每次访问都在折叠长链
+    BinaryTree<string> plain;
+    BinaryTree<string, treap_balance> treap;
+    BinaryTree<string, splay_balance> splay;
+    for (int i = 0; i < 10000; ++i) {
+        string id = "svc-" + to_string(100000 + i);
+        plain.insert(id);
+        treap.insert(id);
+        splay.insert(id);
+    }
+    splay.remove("svc-100000");     // 访问最深的节点，伸展后链的长度折半
+    cout << "\nHeight after 10000 sorted inserts: none " << plain.height()
+         << ", treap " << treap.height() << ", splay " << splay.height() << endl;
+    for (int i = 0; i < 10000; i += 7)
+        splay.contains("svc-" + to_string(100000 + i));
+    cout << "Splay height after scattered lookups: " << splay.height() << endl;
+
     return 0;
 }
\ No newline at end of file
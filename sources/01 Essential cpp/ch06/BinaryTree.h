@@ -1,51 +1,284 @@
 #include <iostream>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if __cpp_impl_three_way_comparison
+#include <compare>
+#endif
+#include "../../00 Algorithm/data stucture/node_pool.h"
 
 using namespace std;
 
-template <typename elemType>
+// 平衡策略，决定插入/删除之后怎样调整树形，以及节点上额外保存什么：
+//   no_balance     不调整（默认），按插入顺序成树，有序输入会退化成链表；
+//   treap_balance  每个节点带一个随机优先级，按优先级维持大根堆，
+//                  不论输入顺序，期望深度都是 O(log n)；
+//   splay_balance  每次 insert/remove/查找都把访问的节点伸展到根，均摊 O(log n)，
+//                  访问集中在少数元素上时它们一直留在根附近。
+// 三种策略都保留 _cnt 计数，重复插入只增加计数。
+struct no_balance {
+    struct node_data {};
+};
+
+struct treap_balance {
+    struct node_data {
+        node_data() : _priority(next_priority()) {}
+        unsigned _priority;
+    };
+    static unsigned next_priority() {
+        static thread_local minstd_rand rng(random_device{}());
+        return rng();
+    }
+};
+
+struct splay_balance {
+    struct node_data {};
+};
+
+// 一次比较得出 a 与 b 的大小关系（负、零、正）。两边都能转成 string_view 时
+// （string、string_view、const char* 等）用 compare 逐字节比较一遍；其余支持 <=> 的类型
+// 只调用一次 <=>；否则（包括 C++17 下编译时）退回到至多两次 <
+template <typename T, typename U, typename = void>
+struct has_three_way : false_type {};
+#if __cpp_impl_three_way_comparison
+template <typename T, typename U>
+struct has_three_way<T, U, void_t<decltype(declval<const T &>() <=> declval<const U &>())>> : true_type {};
+#endif
+
+template <typename T, typename U>
+inline int three_way(const T &a, const U &b) {
+    if constexpr (is_convertible<const T &, string_view>::value && is_convertible<const U &, string_view>::value) {
+        int c = string_view(a).compare(string_view(b));
+        return c < 0 ? -1 : c > 0;
+    } else if constexpr (has_three_way<T, U>::value) {
+#if __cpp_impl_three_way_comparison
+        auto c = a <=> b;
+        return c < 0 ? -1 : c > 0;
+#endif
+    } else {
+        return a < b ? -1 : b < a;
+    }
+}
+
+template <typename elemType, typename BalancePolicy = no_balance>
 class BinaryTree;
 
-template <typename valType>
-class BTnode {
-    friend class BinaryTree<valType>;
+template <typename valType, typename Policy = no_balance>
+class BTnode : Policy::node_data {
+    friend class BinaryTree<valType, Policy>;
 public:
-    BTnode(const valType &val) : _val(val) {
+    BTnode(const valType &val, BTnode *parent = 0) : _val(val) {
         _cnt = 1;
         _left = _right = 0;
+        _parent = parent;
     }
 private:
     valType _val;
     int _cnt;
     BTnode *_left;
     BTnode *_right;
+    BTnode *_parent;    // 遍历靠它回溯，不需要栈也不需要递归
 
-    void insert_value(const valType &val);
-    void remove_value(const valType &val, BTnode *& prev);
-    void preorder(BTnode *pt, ostream &os) const;
+    // 找到 val 所在的节点（_cnt 加一），或者从内存池取一个新节点挂到叶子下面；
+    // inserted 表示是否新建了节点，平衡由 BinaryTree 按策略随后进行
+    BTnode* insert_value(const valType &val, NodePool<BTnode> &pool, bool &inserted);
 };
 
-template <typename elemType>
+template <typename elemType, typename BalancePolicy>
 class BinaryTree {
 public:
-    BinaryTree() : _root(0) {}
+    typedef BTnode<elemType, BalancePolicy> node_type;
+
+    enum order { in_order, pre_order, post_order };
+
+    // 沿 _parent 指针移动的前向迭代器，只有一个指针大小，++ 均摊 O(1)，不分配内存
+    template <order Order>
+    class tree_iterator {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef elemType value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const elemType* pointer;
+        typedef const elemType& reference;
+
+        tree_iterator(const node_type *pt = 0) : _pt(pt) {}
+
+        const elemType& operator*() const { return _pt->_val; }
+        const elemType* operator->() const { return &_pt->_val; }
+        int count() const { return _pt->_cnt; }     // 该元素被插入的次数
+
+        tree_iterator& operator++() {
+            _pt = BinaryTree::next(_pt, Order);
+            return *this;
+        }
+        tree_iterator operator++(int) {
+            tree_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const tree_iterator &rhs) const { return _pt == rhs._pt; }
+        bool operator!=(const tree_iterator &rhs) const { return _pt != rhs._pt; }
+    private:
+        const node_type *_pt;
+    };
+
+    // 层序迭代器：自带一个队列，容量按需倍增，同时最多保存两层节点；
+    // 拷贝迭代器会拷贝队列
+    class level_iterator {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef elemType value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const elemType* pointer;
+        typedef const elemType& reference;
+
+        level_iterator(const node_type *pt = 0) : _head(0) {
+            if (pt) _queue.push_back(pt);
+        }
+
+        const elemType& operator*() const { return _queue[_head]->_val; }
+        const elemType* operator->() const { return &_queue[_head]->_val; }
+        int count() const { return _queue[_head]->_cnt; }
+
+        level_iterator& operator++();
+        level_iterator operator++(int) {
+            level_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const level_iterator &rhs) const {
+            return current() == rhs.current();
+        }
+        bool operator!=(const level_iterator &rhs) const { return !(*this == rhs); }
+    private:
+        const node_type* current() const {
+            return _head < _queue.size() ? _queue[_head] : 0;
+        }
+        vector<const node_type*> _queue;
+        size_t _head;
+    };
+
+    // 供 range-for 使用的一对迭代器
+    template <typename Iter>
+    class range {
+    public:
+        range(Iter b, Iter e) : _begin(b), _end(e) {}
+        Iter begin() const { return _begin; }
+        Iter end() const { return _end; }
+    private:
+        Iter _begin, _end;
+    };
+
+    typedef tree_iterator<in_order> iterator;
+    typedef tree_iterator<in_order> const_iterator;
+    typedef tree_iterator<pre_order> preorder_iterator;
+    typedef tree_iterator<post_order> postorder_iterator;
+
+    BinaryTree() : _root(0), _size(0) {}
     BinaryTree(const BinaryTree &);
+    BinaryTree(BinaryTree &&rhs) noexcept
+        : _root(rhs._root), _size(rhs._size), _nodes(std::move(rhs._nodes)) {
+        rhs._root = 0;
+        rhs._size = 0;
+    }
     ~BinaryTree();
     BinaryTree& operator=(const BinaryTree &);
+    BinaryTree& operator=(BinaryTree &&rhs) noexcept;
 
     bool empty() {return _root == 0; }
+    size_t size() const { return _size; }   // 不同元素的个数
+    int height() const;
     void clear() {
         if (_root) {
             clear(_root);
             _root = 0;
         }
+        _size = 0;
+        _nodes.release();
     }
     void insert(const elemType &elem);
     void remove(const elemType &elem);
 
+    // 查找：key 可以是任何能与 elemType 直接比较的类型，不会构造临时的 elemType，
+    // 例如 BinaryTree<string> 可以直接用 string_view 或 const char* 查询。
+    // splay_balance 的均摊界要求每次访问都伸展：非 const 的查找把找到的节点
+    // （找不到时是最后经过的节点）伸展到根；通过 const 引用查找不改变树形
+    template <typename K>
+    iterator find(const K &key) { return iterator(access(key)); }
+    template <typename K>
+    iterator find(const K &key) const { return iterator(locate(key)); }
+    template <typename K>
+    bool contains(const K &key) { return access(key) != 0; }
+    template <typename K>
+    bool contains(const K &key) const { return locate(key) != 0; }
+    template <typename K>
+    int count(const K &key) {           // 插入的次数，不存在时为 0
+        const node_type *pt = access(key);
+        return pt ? pt->_cnt : 0;
+    }
+    template <typename K>
+    int count(const K &key) const {
+        const node_type *pt = locate(key);
+        return pt ? pt->_cnt : 0;
+    }
+
+    // 默认按中序（从小到大）遍历
+    iterator begin() const { return iterator(first(_root, in_order)); }
+    iterator end() const { return iterator(); }
+
+    range<iterator> inorder_range() const { return range<iterator>(begin(), end()); }
+    range<preorder_iterator> preorder_range() const {
+        return range<preorder_iterator>(preorder_iterator(first(_root, pre_order)), preorder_iterator());
+    }
+    range<postorder_iterator> postorder_range() const {
+        return range<postorder_iterator>(postorder_iterator(first(_root, post_order)), postorder_iterator());
+    }
+    range<level_iterator> levelorder_range() const {
+        return range<level_iterator>(level_iterator(_root), level_iterator());
+    }
+
     void preorder();
+    // 按中序写成可 mmap 的扁平文件，值为每个元素出现的次数，
+    // 用 FlatTree<elemType, int> 只读打开（见 flat_tree.h）
+    void save_flat(const string &path) const;
 private:
-    BTnode<elemType> *_root;
-    void copy(BTnode<elemType> *tar, BTnode<elemType> *src);
-    void remove_root();
-    void clear(BTnode<elemType> *);
-};
\ No newline at end of file
+    node_type *_root;
+    size_t _size;
+    NodePool<node_type> _nodes;
+
+    // 克隆：所有节点按前序连续放在一块内存里，较大的子树分给其他线程并行复制
+    void clone(const BinaryTree &rhs);
+    static node_type* clone(const node_type *src, node_type *slot, node_type *parent);
+    static node_type* clone(const node_type *src, node_type *slot, node_type *parent, int depth);
+    static size_t subtree_size(const node_type *pt);
+    // 连同 _cnt 和平衡策略的附加信息一起复制，不复制指针
+    static node_type* copy_node(const node_type *src, node_type *slot, node_type *parent) {
+        node_type *pt = new (slot) node_type(*src);
+        pt->_left = pt->_right = 0;
+        pt->_parent = parent;
+        return pt;
+    }
+    // 复制中途抛出异常时，析构 [first, last) 中已经构造好的节点，槽位由调用者归还
+    static void destroy_slots(node_type *first, node_type *last) {
+        for (; first != last; ++first)
+            first->~node_type();
+    }
+
+    template <typename K>
+    const node_type* locate(const K &key) const;
+    // 同 locate，splay_balance 时顺带伸展
+    template <typename K>
+    const node_type* access(const K &key);
+    void replace_child(node_type *parent, node_type *old, node_type *now);
+    void rotate_up(node_type *pt);
+    void splay(node_type *pt);
+    void clear(node_type *);
+
+    // 某种顺序下以 pt 为根的子树中的第一个节点，以及 pt 的后继
+    static const node_type* first(const node_type *pt, order ord);
+    static const node_type* next(const node_type *pt, order ord);
+};
@@ -0,0 +1,456 @@
+#include "RadixTree.h"
+#include "BinaryTree.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+RadixTree& RadixTree::operator=(RadixTree &&rhs) noexcept {
+    if (this != &rhs) {
+        clear();
+        _root = rhs._root;
+        _size = rhs._size;
+        rhs._root = 0;
+        rhs._size = 0;
+    }
+
+    return *this;
+}
+
+void RadixTree::clear() {
+    vector<Node*> pending;
+    if (_root) pending.push_back(_root);
+    while (!pending.empty()) {
+        Node *pt = pending.back();
+        pending.pop_back();
+        int byte = 0;
+        for (const Node *child = next_child(pt, 0, byte); child; child = next_child(pt, byte + 1, byte))
+            pending.push_back(const_cast<Node*>(child));
+        free_node(pt);
+    }
+    _root = 0;
+    _size = 0;
+}
+
+void RadixTree::insert(string_view key) {
+    Node **ref = &_root;
+    size_t depth = 0;
+    while (true) {
+        Node *pt = *ref;
+        if (!pt) {
+            pt = *ref = new Node(leaf);
+            pt->_prefix = key.substr(depth);
+            pt->_cnt = 1;
+            ++_size;
+            return;
+        }
+
+        const string &prefix = pt->_prefix;
+        size_t same = 0, limit = min(prefix.size(), key.size() - depth);
+        while (same < limit && prefix[same] == key[depth + same]) ++same;
+
+        if (same < prefix.size()) {
+            // 键在前缀中间分叉：拆出一个 Node4，公共部分归它，pt 只留下分叉字节之后的部分
+            Node *split = new Node4;
+            split->_prefix.assign(prefix, 0, same);
+            unsigned char byte = prefix[same];
+            pt->_prefix.erase(0, same + 1);
+            *ref = split;
+            add_child(*ref, byte, pt);
+            if (depth + same == key.size()) {
+                split->_cnt = 1;
+            } else {
+                Node *rest = new Node(leaf);
+                rest->_prefix = key.substr(depth + same + 1);
+                rest->_cnt = 1;
+                add_child(*ref, key[depth + same], rest);
+            }
+            ++_size;
+            return;
+        }
+
+        depth += same;
+        if (depth == key.size()) {
+            if (pt->_cnt++ == 0) ++_size;
+            return;
+        }
+
+        unsigned char byte = key[depth++];
+        if (Node **slot = child_slot(pt, byte)) {
+            ref = slot;
+            continue;
+        }
+        Node *rest = new Node(leaf);
+        rest->_prefix = key.substr(depth);
+        rest->_cnt = 1;
+        add_child(*ref, byte, rest);
+        ++_size;
+        return;
+    }
+}
+
+void RadixTree::remove(string_view key) {
+    Node **ref = &_root, **parent = 0;
+    size_t depth = 0;
+    unsigned char byte = 0;
+    while (Node *pt = *ref) {
+        const string &prefix = pt->_prefix;
+        if (key.size() - depth < prefix.size() || key.compare(depth, prefix.size(), prefix) != 0) return;
+        depth += prefix.size();
+
+        if (depth == key.size()) {
+            if (pt->_cnt == 0) return;
+            pt->_cnt = 0;
+            --_size;
+            if (pt->_children == 0) {
+                free_node(pt);
+                if (parent) {
+                    remove_child(*parent, byte);
+                    compact(*parent);
+                } else {
+                    _root = 0;
+                }
+            } else {
+                compact(*ref);
+            }
+            return;
+        }
+
+        byte = key[depth++];
+        parent = ref;
+        ref = child_slot(pt, byte);
+        if (!ref) return;
+    }
+}
+
+int RadixTree::count(string_view key) const {
+    const Node *pt = locate(key);
+    return pt ? pt->_cnt : 0;
+}
+
+const RadixTree::Node* RadixTree::locate(string_view key) const {
+    const Node *pt = _root;
+    size_t depth = 0;
+    while (pt) {
+        const string &prefix = pt->_prefix;
+        if (key.size() - depth < prefix.size() || key.compare(depth, prefix.size(), prefix) != 0) return 0;
+        depth += prefix.size();
+        if (depth == key.size()) return pt;
+        pt = find_child(pt, key[depth++]);
+    }
+
+    return 0;
+}
+
+size_t RadixTree::memory() const {
+    static const size_t inline_capacity = string().capacity();
+    size_t bytes = 0;
+    vector<const Node*> pending;
+    if (_root) pending.push_back(_root);
+    while (!pending.empty()) {
+        const Node *pt = pending.back();
+        pending.pop_back();
+        switch (pt->_kind) {
+        case leaf: bytes += sizeof(Node); break;
+        case node4: bytes += sizeof(Node4); break;
+        case node16: bytes += sizeof(Node16); break;
+        case node48: bytes += sizeof(Node48); break;
+        case node256: bytes += sizeof(Node256); break;
+        }
+        if (pt->_prefix.capacity() > inline_capacity) bytes += pt->_prefix.capacity() + 1;
+        int byte = 0;
+        for (const Node *child = next_child(pt, 0, byte); child; child = next_child(pt, byte + 1, byte))
+            pending.push_back(child);
+    }
+
+    return bytes;
+}
+
+RadixTree::Node* RadixTree::find_child(const Node *pt, unsigned char byte) {
+    Node **slot = child_slot(const_cast<Node*>(pt), byte);
+    return slot ? *slot : 0;
+}
+
+RadixTree::Node** RadixTree::child_slot(Node *pt, unsigned char byte) {
+    switch (pt->_kind) {
+    case leaf:
+        return 0;
+    case node4: {
+        Node4 *n = static_cast<Node4*>(pt);
+        for (int i = 0; i < n->_children; ++i)
+            if (n->_keys[i] == byte) return &n->_child[i];
+        return 0;
+    }
+    case node16: {
+        Node16 *n = static_cast<Node16*>(pt);
+#ifdef __SSE2__
+        __m128i eq = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->_keys)));
+        unsigned mask = _mm_movemask_epi8(eq) & ((1u << n->_children) - 1);
+        return mask ? &n->_child[__builtin_ctz(mask)] : 0;
+#else
+        for (int i = 0; i < n->_children; ++i)
+            if (n->_keys[i] == byte) return &n->_child[i];
+        return 0;
+#endif
+    }
+    case node48: {
+        Node48 *n = static_cast<Node48*>(pt);
+        return n->_index[byte] ? &n->_child[n->_index[byte] - 1] : 0;
+    }
+    case node256: {
+        Node256 *n = static_cast<Node256*>(pt);
+        return n->_child[byte] ? &n->_child[byte] : 0;
+    }
+    }
+
+    return 0;
+}
+
+const RadixTree::Node* RadixTree::next_child(const Node *pt, int from, int &byte) {
+    switch (pt->_kind) {
+    case leaf:
+        return 0;
+    case node4:
+    case node16: {
+        const unsigned char *keys = pt->_kind == node4 ? static_cast<const Node4*>(pt)->_keys
+                                                       : static_cast<const Node16*>(pt)->_keys;
+        Node *const *child = pt->_kind == node4 ? static_cast<const Node4*>(pt)->_child
+                                                : static_cast<const Node16*>(pt)->_child;
+        for (int i = 0; i < pt->_children; ++i)
+            if (keys[i] >= from) {
+                byte = keys[i];
+                return child[i];
+            }
+        return 0;
+    }
+    case node48: {
+        const Node48 *n = static_cast<const Node48*>(pt);
+        for (int b = from; b < 256; ++b)
+            if (n->_index[b]) {
+                byte = b;
+                return n->_child[n->_index[b] - 1];
+            }
+        return 0;
+    }
+    case node256: {
+        const Node256 *n = static_cast<const Node256*>(pt);
+        for (int b = from; b < 256; ++b)
+            if (n->_child[b]) {
+                byte = b;
+                return n->_child[b];
+            }
+        return 0;
+    }
+    }
+
+    return 0;
+}
+
+void RadixTree::add_child(Node *&ref, unsigned char byte, Node *child) {
+    Node *pt = ref;
+    switch (pt->_kind) {
+    case leaf: pt = resize(pt, node4); break;
+    case node4: if (pt->_children == 4) pt = resize(pt, node16); break;
+    case node16: if (pt->_children == 16) pt = resize(pt, node48); break;
+    case node48: if (pt->_children == 48) pt = resize(pt, node256); break;
+    case node256: break;
+    }
+    ref = pt;
+
+    switch (pt->_kind) {
+    case leaf:
+        break;
+    case node4:
+    case node16: {
+        unsigned char *keys = pt->_kind == node4 ? static_cast<Node4*>(pt)->_keys : static_cast<Node16*>(pt)->_keys;
+        Node **slots = pt->_kind == node4 ? static_cast<Node4*>(pt)->_child : static_cast<Node16*>(pt)->_child;
+        // 保持字节有序，遍历时才能按顺序输出
+        int i = pt->_children;
+        while (i > 0 && keys[i - 1] > byte) {
+            keys[i] = keys[i - 1];
+            slots[i] = slots[i - 1];
+            --i;
+        }
+        keys[i] = byte;
+        slots[i] = child;
+        break;
+    }
+    case node48: {
+        Node48 *n = static_cast<Node48*>(pt);
+        int slot = 0;
+        while (n->_child[slot]) ++slot;
+        n->_child[slot] = child;
+        n->_index[byte] = slot + 1;
+        break;
+    }
+    case node256:
+        static_cast<Node256*>(pt)->_child[byte] = child;
+        break;
+    }
+    ++pt->_children;
+}
+
+void RadixTree::remove_child(Node *&ref, unsigned char byte) {
+    Node *pt = ref;
+    switch (pt->_kind) {
+    case leaf:
+        return;
+    case node4:
+    case node16: {
+        unsigned char *keys = pt->_kind == node4 ? static_cast<Node4*>(pt)->_keys : static_cast<Node16*>(pt)->_keys;
+        Node **slots = pt->_kind == node4 ? static_cast<Node4*>(pt)->_child : static_cast<Node16*>(pt)->_child;
+        int i = 0;
+        while (keys[i] != byte) ++i;
+        for (; i + 1 < pt->_children; ++i) {
+            keys[i] = keys[i + 1];
+            slots[i] = slots[i + 1];
+        }
+        break;
+    }
+    case node48: {
+        Node48 *n = static_cast<Node48*>(pt);
+        n->_child[n->_index[byte] - 1] = 0;
+        n->_index[byte] = 0;
+        break;
+    }
+    case node256:
+        static_cast<Node256*>(pt)->_child[byte] = 0;
+        break;
+    }
+    --pt->_children;
+
+    // 收缩时留一点余量，避免在边界上反复插入删除时来回换节点
+    if (pt->_kind == node16 && pt->_children <= 3) ref = resize(pt, node4);
+    else if (pt->_kind == node48 && pt->_children <= 12) ref = resize(pt, node16);
+    else if (pt->_kind == node256 && pt->_children <= 37) ref = resize(pt, node48);
+}
+
+void RadixTree::compact(Node *&ref) {
+    Node *pt = ref;
+    if (pt->_cnt == 0 && pt->_children == 1) {
+        int byte = 0;
+        Node *child = const_cast<Node*>(next_child(pt, 0, byte));
+        child->_prefix.insert(child->_prefix.begin(), static_cast<char>(byte));
+        child->_prefix.insert(0, pt->_prefix);
+        free_node(pt);
+        ref = child;
+    } else if (pt->_children == 0 && pt->_kind != leaf) {
+        ref = resize(pt, leaf);
+    }
+}
+
+// 换成 kind 类型的节点，前缀、计数和全部孩子原样搬过去，释放原节点
+RadixTree::Node* RadixTree::resize(Node *pt, node_kind kind) {
+    Node *to;
+    switch (kind) {
+    case leaf: to = new Node(leaf); break;
+    case node4: to = new Node4; break;
+    case node16: to = new Node16; break;
+    case node48: to = new Node48; break;
+    default: to = new Node256; break;
+    }
+    to->_cnt = pt->_cnt;
+    to->_prefix = std::move(pt->_prefix);
+
+    int byte = 0;
+    for (const Node *child = next_child(pt, 0, byte); child; child = next_child(pt, byte + 1, byte))
+        add_child(to, byte, const_cast<Node*>(child));
+    free_node(pt);
+
+    return to;
+}
+
+void RadixTree::free_node(Node *pt) {
+    switch (pt->_kind) {
+    case leaf: delete pt; break;
+    case node4: delete static_cast<Node4*>(pt); break;
+    case node16: delete static_cast<Node16*>(pt); break;
+    case node48: delete static_cast<Node48*>(pt); break;
+    case node256: delete static_cast<Node256*>(pt); break;
+    }
+}
+
+int RadixTree::const_iterator::count() const {
+    return _stack.back().node->_cnt;
+}
+
+RadixTree::const_iterator::const_iterator(const Node *pt, string_view path) : _key(path) {
+    push(pt);
+    if (pt->_cnt == 0) advance();
+}
+
+void RadixTree::const_iterator::push(const Node *pt) {
+    Frame frame = {pt, 0, _key.size()};
+    _stack.push_back(frame);
+    _key += pt->_prefix;
+}
+
+// 前序：节点自己的键排在所有孩子之前（"ab" < "abc"），孩子按字节从小到大
+void RadixTree::const_iterator::advance() {
+    while (!_stack.empty()) {
+        Frame &top = _stack.back();
+        int byte = 0;
+        const Node *child = next_child(top.node, top.next, byte);
+        if (!child) {
+            _key.resize(top.len);
+            _stack.pop_back();
+            continue;
+        }
+        top.next = byte + 1;
+        _key.resize(top.len + top.node->_prefix.size());
+        _key.push_back(static_cast<char>(byte));
+        push(child);
+        if (child->_cnt) return;
+    }
+}
+
+int main() {
+    RadixTree rt;
+
+    rt.insert("Piglet");
+    rt.insert("Eeyore");
+    rt.insert("Roo");
+    rt.insert("Tigger");
+    rt.insert("Chris");
+    rt.insert("Pooh");
+    rt.insert("Kanga");
+    rt.insert("Roo");
+
+    cout << "Sorted: " << endl;
+    for (RadixTree::iterator it = rt.begin(); it != rt.end(); ++it)
+        cout << *it << "(" << it.count() << ")  ";
+    cout << "\n\n";
+
+    rt.remove("Piglet");
+    cout << "After removing Piglet, names starting with P: ";
+    rt.for_each_prefix("P", [](const string &name, int) { cout << name << "  "; });
+    cout << "\n\n";
+
+    // 共享长前缀的服务路径：与同样的键放在 BinaryTree<string> 里时的节点和字符串内存比较
+    RadixTree paths;
+    mt19937 rng(42);
+    const char *services[] = {"billing/invoice", "billing/refund", "search/query", "search/index"};
+    for (int i = 0; i < 100000; ++i) {
+        string path = "tenant-" + to_string(rng() % 500) + "/service/" + services[rng() % 4] + "/shard-" +
+                      to_string(rng() % 64);
+        paths.insert(path);
+    }
+    size_t bst_bytes = 0;
+    for (const string &path : paths) {
+        bst_bytes += sizeof(BTnode<string>);
+        if (path.size() > string().capacity()) bst_bytes += path.size() + 1;
+    }
+
+    size_t matched = 0;
+    paths.for_each_prefix("tenant-42/service/search/", [&matched](const string &, int) { ++matched; });
+    cout << paths.size() << " distinct paths: radix tree " << paths.memory() / 1024 << " KB, binary tree "
+         << bst_bytes / 1024 << " KB" << endl;
+    cout << matched << " search shards under tenant-42, first path: " << *paths.begin() << endl;
+
+    return 0;
+}
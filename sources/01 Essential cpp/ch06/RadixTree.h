@@ -0,0 +1,163 @@
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// 自适应基数树（Adaptive Radix Tree）：按键的字节逐层分叉的压缩字典树，保存一个 string 多重集合。
+// insert/remove/count 与 BinaryTree 的语义相同：重复插入只增加计数，remove 删除整个键。
+// 内部节点按孩子的个数在四种大小之间增长和收缩：
+//   Node4、Node16  有序的字节数组加指针数组，Node16 用 SSE2 一次比较 16 个字节；
+//   Node48         256 项的字节索引，指向 48 个指针槽；
+//   Node256        直接用字节做下标。
+// 只有一个孩子的路径压缩进节点的 _prefix，前缀完整保存，所以根到节点的路径就确定了键，
+// 叶子不再保存整个键；共同前缀很长的键（tenant/service 路径之类）只存一份前缀。
+// 查找是 O(键长)，与元素个数无关，每个节点只看一个字节。
+// 遍历按字节（unsigned char）顺序，与 string 的 < 一致。
+class RadixTree {
+    struct Node;
+public:
+    // 按键的顺序遍历，*it 是键，it.count() 是插入的次数；
+    // 迭代器自带一个栈和键的缓冲区，树被修改后失效
+    class const_iterator {
+        friend class RadixTree;
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef string value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const string* pointer;
+        typedef const string& reference;
+
+        const_iterator() {}
+
+        const string& operator*() const { return _key; }
+        const string* operator->() const { return &_key; }
+        int count() const;
+
+        const_iterator& operator++() {
+            advance();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const const_iterator &rhs) const { return current() == rhs.current(); }
+        bool operator!=(const const_iterator &rhs) const { return current() != rhs.current(); }
+    private:
+        // 遍历以 pt 为根的子树，path 是到 pt 为止（不含 pt 的前缀）的键
+        const_iterator(const Node *pt, string_view path);
+
+        struct Frame {
+            const Node *node;
+            int next;       // 下一个要访问的孩子的最小字节
+            size_t len;     // 进入 node 之前 _key 的长度
+        };
+        const Node* current() const { return _stack.empty() ? 0 : _stack.back().node; }
+        void push(const Node *pt);
+        void advance();
+
+        vector<Frame> _stack;
+        string _key;
+    };
+    typedef const_iterator iterator;
+
+    RadixTree() : _root(0), _size(0) {}
+    RadixTree(const RadixTree &) = delete;
+    RadixTree& operator=(const RadixTree &) = delete;
+    RadixTree(RadixTree &&rhs) noexcept : _root(rhs._root), _size(rhs._size) {
+        rhs._root = 0;
+        rhs._size = 0;
+    }
+    RadixTree& operator=(RadixTree &&rhs) noexcept;
+    ~RadixTree() { clear(); }
+
+    bool empty() const { return _root == 0; }
+    size_t size() const { return _size; }   // 不同键的个数
+    void clear();
+
+    void insert(string_view key);
+    void remove(string_view key);
+    int count(string_view key) const;       // 插入的次数，不存在时为 0
+    bool contains(string_view key) const { return count(key) != 0; }
+
+    const_iterator begin() const { return _root ? const_iterator(_root, string_view()) : end(); }
+    const_iterator end() const { return const_iterator(); }
+
+    // 按顺序访问所有以 prefix 开头的键：f(key, count)
+    template <typename F>
+    void for_each_prefix(string_view prefix, F f) const;
+
+    // 节点和放不进 string 内部缓冲区的前缀一共占用的字节数
+    size_t memory() const;
+private:
+    enum node_kind : uint8_t { leaf, node4, node16, node48, node256 };
+
+    struct Node {
+        Node(node_kind kind) : _kind(kind), _children(0), _cnt(0) {}
+        node_kind _kind;
+        uint16_t _children;
+        int _cnt;           // 在此结束的键被插入的次数，0 表示没有键在此结束
+        string _prefix;     // 进入该节点的字节之后被压缩掉的那一段
+    };
+    struct Node4 : Node {
+        Node4() : Node(node4) {}
+        unsigned char _keys[4];
+        Node *_child[4];
+    };
+    struct Node16 : Node {
+        Node16() : Node(node16) {}
+        unsigned char _keys[16];
+        Node *_child[16];
+    };
+    struct Node48 : Node {
+        Node48() : Node(node48), _index() {}
+        unsigned char _index[256];  // 0 表示没有孩子，否则是槽位下标加一
+        Node *_child[48] = {};
+    };
+    struct Node256 : Node {
+        Node256() : Node(node256) {}
+        Node *_child[256] = {};
+    };
+
+    const Node* locate(string_view key) const;
+
+    static Node* find_child(const Node *pt, unsigned char byte);
+    static Node** child_slot(Node *pt, unsigned char byte);
+    // 字节不小于 from 的第一个孩子，byte 返回它的字节；没有时返回 0
+    static const Node* next_child(const Node *pt, int from, int &byte);
+    // 满了先换成更大的节点，ref 随之更新
+    static void add_child(Node *&ref, unsigned char byte, Node *child);
+    // 孩子太少时换成更小的节点
+    static void remove_child(Node *&ref, unsigned char byte);
+    // 没有键在此结束、只剩一个孩子的节点并入孩子；没有孩子的内部节点换成叶子
+    static void compact(Node *&ref);
+    static Node* resize(Node *pt, node_kind kind);
+    static void free_node(Node *pt);
+
+    Node *_root;
+    size_t _size;
+};
+
+template <typename F>
+void RadixTree::for_each_prefix(string_view prefix, F f) const {
+    const Node *pt = _root;
+    size_t depth = 0;
+    while (pt) {
+        // prefix 在这个节点的前缀之内结束：整棵子树都匹配
+        string_view rest = prefix.substr(depth);
+        if (rest.size() <= pt->_prefix.size()) {
+            if (pt->_prefix.compare(0, rest.size(), rest) != 0) return;
+            for (const_iterator it(pt, prefix.substr(0, depth)), end; it != end; ++it)
+                f(*it, it.count());
+            return;
+        }
+        if (rest.compare(0, pt->_prefix.size(), pt->_prefix) != 0) return;
+        depth += pt->_prefix.size();
+        pt = find_child(pt, prefix[depth++]);
+    }
+}